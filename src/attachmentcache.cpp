@@ -0,0 +1,85 @@
+
+#include "attachmentcache.h"
+
+//**********************************************************************************************************************
+// region AttachmentCache
+//======================================================================================================================
+std::int64_t AttachmentCache::getExpiryTime(const juce::String &url, std::int64_t nowMs)
+{
+    const juce::URL    parsed(url);
+    const int          index = parsed.getParameterNames().indexOf("ex");
+    const juce::String value = (index >= 0 ? parsed.getParameterValues()[index] : juce::String());
+    
+    // The parameter holds the expiry as unix time in seconds, written in hex
+    if (value.isNotEmpty() && value.containsOnly("0123456789abcdefABCDEF"))
+    {
+        return value.getHexValue64() * 1000;
+    }
+    
+    return nowMs + defaultLifetimeMs;
+}
+
+//======================================================================================================================
+void AttachmentCache::remember(const std::string &key, const std::string &url, std::int64_t nowMs)
+{
+    const std::int64_t expiry_time = getExpiryTime(url, nowMs);
+    
+    if (expiry_time - safetyMarginMs <= nowMs)
+    {
+        return;
+    }
+    
+    const std::lock_guard lock(mutex);
+    
+    if (entries.size() >= pruneThreshold)
+    {
+        pruneExpired(nowMs);
+    }
+    
+    entries[key] = Entry{ url, expiry_time };
+}
+
+std::string AttachmentCache::find(const std::string &key, std::int64_t nowMs)
+{
+    const std::lock_guard lock(mutex);
+    
+    auto it = entries.find(key);
+    
+    if (it == entries.end())
+    {
+        return {};
+    }
+    
+    if (it->second.expiryTime - safetyMarginMs <= nowMs)
+    {
+        entries.erase(it);
+        return {};
+    }
+    
+    return it->second.url;
+}
+
+void AttachmentCache::forget(const std::string &key)
+{
+    const std::lock_guard lock(mutex);
+    (void) entries.erase(key);
+}
+
+//======================================================================================================================
+std::size_t AttachmentCache::size() const
+{
+    const std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+//======================================================================================================================
+void AttachmentCache::pruneExpired(std::int64_t nowMs)
+{
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        it = (it->second.expiryTime - safetyMarginMs <= nowMs ? entries.erase(it) : std::next(it));
+    }
+}
+//======================================================================================================================
+// endregion AttachmentCache
+//**********************************************************************************************************************
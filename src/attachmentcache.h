@@ -0,0 +1,52 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//======================================================================================================================
+/**
+ *  Remembers where Discord put the images that were uploaded, so that the same image can be linked to instead of
+ *  being uploaded again.
+ *  Discord's attachment links are signed and stop working after a while, a link is only handed out while it has some
+ *  time left, after that the image has to be uploaded again.
+ *  Nothing in here talks to Discord, times are passed in, so this works the same against any stand-in.
+ */
+class AttachmentCache
+{
+public:
+    /** Gets when a link stops working, from its ex parameter if it has one. */
+    static std::int64_t getExpiryTime(const juce::String &url, std::int64_t nowMs);
+    
+    //==================================================================================================================
+    void        remember(const std::string &key, const std::string &url,
+                         std::int64_t nowMs = juce::Time::currentTimeMillis());
+    std::string find(const std::string &key, std::int64_t nowMs = juce::Time::currentTimeMillis());
+    void        forget(const std::string &key);
+    
+    //==================================================================================================================
+    std::size_t size() const;
+    
+private:
+    struct Entry
+    {
+        std::string  url;
+        std::int64_t expiryTime;
+    };
+    
+    //==================================================================================================================
+    // Links without an expiry are still not trusted forever, and none is used right before it runs out
+    static constexpr std::int64_t defaultLifetimeMs = 24 * 60 * 60 * 1000;
+    static constexpr std::int64_t safetyMarginMs    = 60 * 60 * 1000;
+    static constexpr std::size_t  pruneThreshold    = 4096;
+    
+    //==================================================================================================================
+    std::unordered_map<std::string, Entry> entries;
+    mutable std::mutex                     mutex;
+    
+    //==================================================================================================================
+    void pruneExpired(std::int64_t nowMs);
+};
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "querybudget.h"
 #include "specs.h"
 
 // JUCE
@@ -41,4 +42,8 @@ public:
 
 protected:
     JuceDocClient &client;
+    
+    //==================================================================================================================
+    /** Creates the time and work allowance a single invocation gets, as configured on start-up. */
+    static QueryBudget createBudget();
 };
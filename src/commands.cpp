@@ -2,16 +2,16 @@
 #include "commands.h"
 
 #include "config.h"
-#include "entitydefinition.h"
 #include "jucedocclient.h"
-#include "linkresolve.h"
+#include "singleflight.h"
 
-// Doxygen
-#include <definition.h>
-#include <memberdef.h>
 // sleepy-discord
 #include <sleepy_discord/sleepy_discord.h>
 
+// STL
+#include <mutex>
+#include <optional>
+
 #if JUCE_DEBUG
 #   define JD_DBG(MSG) client.getLogger().debug(MSG)
 #else
@@ -24,13 +24,639 @@ namespace sld = SleepyDiscord;
 //======================================================================================================================
 namespace
 {
+    juce::String toString(std::string_view text)
+    {
+        return juce::String::fromUTF8(text.data(), static_cast<int>(text.size()));
+    }
+    
     std::string toCodeBlock(const juce::String &blockType, const juce::String text)
     {
         return "```" + blockType.toStdString() + "\n" + text.trimCharactersAtEnd("\n ").toStdString() + "\n```";
     }
     
+    juce::String toCandidateList(const std::vector<const SymbolIndex::Entity*> &candidates)
+    {
+        static constexpr std::size_t max_candidates = 10;
+        
+        juce::String output;
+        
+        for (std::size_t i = 0; i < std::min(candidates.size(), max_candidates); ++i)
+        {
+            output << "`" << candidates[i]->qualifiedName << "` (" << candidates[i]->type->name().data() << ")\n";
+        }
+        
+        if (candidates.size() > max_candidates)
+        {
+            output << "_... and " << static_cast<int>(candidates.size() - max_candidates) << " more_";
+        }
+        
+        return output;
+    }
+    
+    std::string toMessageContent(const juce::String &text)
+    {
+        static constexpr int max_content_length = 2000;
+        
+        const juce::String content = text.trim();
+        return (content.length() > max_content_length ? content.substring(0, max_content_length - 3) + "..."
+                                                      : content).toStdString();
+    }
+    
+    std::size_t getEmbedLength(const sld::Embed &embed)
+    {
+        std::size_t length = embed.title.size() + embed.description.size() + embed.footer.text.size()
+                             + embed.author.name.size();
+        
+        for (const auto &field : embed.fields)
+        {
+            length += field.name.size() + field.value.size();
+        }
+        
+        return length;
+    }
+    
+    //==================================================================================================================
+    template<class Fn>
+    void runParallel(juce::ThreadPool &pool, std::size_t count, Fn &&func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        
+        juce::WaitableEvent      finished;
+        std::atomic<std::size_t> remaining { count - 1 };
+        
+        for (std::size_t i = 1; i < count; ++i)
+        {
+            pool.addJob([&func, &finished, &remaining, i]
+            {
+                func(i);
+                
+                if (remaining.fetch_sub(1) == 1)
+                {
+                    finished.signal();
+                }
+            });
+        }
+        
+        // The calling thread takes its own share instead of idling
+        func(0);
+        
+        if (count > 1)
+        {
+            (void) finished.wait();
+        }
+    }
+    
     //==================================================================================================================
-    bool executeListCommand(const sld::Message &msg, JuceDocClient &client, const juce::StringArray &args, bool isList)
+    bool parseGraphLimit(const juce::String &arg, const char *prefix, int &limit, juce::String &notices)
+    {
+        if (!arg.startsWithIgnoreCase(prefix))
+        {
+            return false;
+        }
+        
+        const juce::String value = arg.fromFirstOccurrenceOf(":", false, false);
+        
+        if (value.containsOnly("0123456789") && value.isNotEmpty())
+        {
+            limit = juce::jlimit(1, limit, value.getIntValue());
+        }
+        else
+        {
+            notices << "**" << arg << "** is not a valid limit, it takes a positive number. Using "
+                    << limit << " instead.\n";
+        }
+        
+        return true;
+    }
+    
+    //==================================================================================================================
+    // Streamed scans outlive the command that started them, identical requests meanwhile share their results.
+    // Nothing else needs this, commands are run one after the other on the gateway thread.
+    SingleFlight<std::shared_ptr<PagedEmbed::ResultSet>> listFlights;
+    
+    std::shared_ptr<const juce::File> toTemporaryFile(const juce::File &file)
+    {
+        return std::shared_ptr<const juce::File>(new juce::File(file), [](const juce::File *ptr)
+        {
+            (void) ptr->deleteFile();
+            delete ptr;
+        });
+    }
+    
+    ShowResult createShowResult(JuceDocClient &client, const SymbolIndex::Entity &entity)
+    {
+        const SymbolIndex::Details details = client.getIndex().getDetails(entity.id);
+        
+        const AppConfig    &config = AppConfig::getInstance();
+        const juce::String doc_url = AppInfo::urlJuceDocsBase.data() + config.branchName + "/";
+        const EntityType   type    = entity.type;
+        
+        ShowResult result;
+        sld::Embed &embed    = result.embed;
+        embed.color          = Colours::Show;
+        embed.author.iconUrl = AppIcon::values[type->ordinal()]->getUrl();
+        embed.author.name    = type->name();
+        embed.title          = std::string(details.name) + (type == EntityType::Function ? "()" : "");
+        embed.url            = doc_url.toStdString() + std::string(client.getIndex().getDocPath(entity.id));
+        embed.description    = std::string(details.documentation);
+        embed.timestamp      = config.currentCommit.date.toStdString();
+        embed.footer.iconUrl = AppIcon::LogoGitHub.getUrl();
+        embed.footer.text    = config.currentCommit.name.substring(0, 9).toStdString()
+                               + " (" + config.branchName.toStdString() + ")";
+        
+        if (!details.definition.empty())
+        {
+            embed.fields.emplace_back("Definition", ::toCodeBlock("cpp", ::toString(details.definition)));
+        }
+        
+        embed.fields.emplace_back("Details", ::toCodeBlock("yaml", "Path:   " + entity.qualifiedName    + "\n"
+                                                                   + "Module: " + ::toString(details.module) + "\n"
+                                                                   + "Parent: " + ::toString(details.parent)));
+        
+        if (!details.parameters.empty())
+        {
+            embed.fields.emplace_back("Parameters", ::toCodeBlock("yaml", ::toString(details.parameters)));
+        }
+        
+        if (!details.enumerators.empty())
+        {
+            embed.fields.emplace_back("Enumerators", ::toCodeBlock("yaml", ::toString(details.enumerators)));
+        }
+        
+        if (!details.examples.empty())
+        {
+            juce::String example_list;
+            
+            for (std::size_t i = 0; i < details.examples.size(); ++i)
+            {
+                example_list << "Example " << static_cast<int>(i + 1)
+                             << ::toCodeBlock("cpp", ::toString(details.examples[i]));
+            }
+            
+            embed.fields.emplace_back("Examples", example_list.toStdString());
+        }
+        
+        if (!details.seeAlso.empty())
+        {
+            embed.fields.emplace_back("See also", std::string(details.seeAlso));
+        }
+        
+        // The graph takes far longer than all of the above, it's rendered separately by the render pool
+        if (type == EntityType::Class)
+        {
+            result.needsGraph = !client.getIndex().getBases(entity.id).empty();
+        }
+        
+        result.serialised = sld::json::stringifyObj(embed);
+        
+        return result;
+    }
+    
+    ShowCache::ResultPtr withGraph(const ShowResult &textResult, RenderPool::Image graph)
+    {
+        ShowResult result      = textResult;
+        result.embed.image.url = "attachment://" + graph->getFileName().toStdString();
+        result.graph           = std::move(graph);
+        result.needsGraph      = false;
+        result.serialised      = sld::json::stringifyObj(result.embed);
+        return std::make_shared<const ShowResult>(std::move(result));
+    }
+    
+    // Discord allows 1024 characters per field, the code block around the tree needs a few of these
+    constexpr std::size_t maxTreeLength = 1000;
+    
+    void appendBases(const SymbolIndex &index, SymbolIndex::EntityId id, const std::string &indent, int level,
+                     GraphLimits limits, std::string &tree)
+    {
+        const SymbolIndex::RelativeList &bases     = index.getBases(id);
+        const int                       num_shown = (level < limits.depth
+                                                         ? std::min(limits.width, static_cast<int>(bases.size()))
+                                                         : 0);
+        const int                       num_left  = static_cast<int>(bases.size()) - num_shown;
+        
+        for (int i = 0; i < num_shown && tree.size() < maxTreeLength; ++i)
+        {
+            const SymbolIndex::Relative &base    = bases[static_cast<std::size_t>(i)];
+            const bool                  is_last = (i == num_shown - 1 && num_left == 0);
+            
+            tree += indent + (is_last ? u8"└─ " : u8"├─ ") + index.getName(base).toStdString()
+                    + (base.isVirtual ? " (virtual)" : "") + "\n";
+            
+            if (base.isIndexed())
+            {
+                ::appendBases(index, base.id, indent + (is_last ? "   " : u8"│  "), level + 1, limits, tree);
+            }
+        }
+        
+        if (num_left > 0 && tree.size() < maxTreeLength)
+        {
+            tree += indent + u8"└─ " + std::to_string(num_left) + " more...\n";
+        }
+    }
+    
+    /** Draws the bases of a class as an indented tree, for when there is no time or no wish for a graph. */
+    juce::String toHierarchyTree(const SymbolIndex &index, SymbolIndex::EntityId id, GraphLimits limits)
+    {
+        std::string tree = index.getEntity(id).qualifiedName.toStdString() + "\n";
+        ::appendBases(index, id, "", 0, limits, tree);
+        
+        if (tree.size() > maxTreeLength)
+        {
+            tree.resize(tree.rfind('\n', maxTreeLength) + 1);
+            tree += "...\n";
+        }
+        
+        return juce::String::fromUTF8(tree.data(), static_cast<int>(tree.size()));
+    }
+    
+    ShowCache::ResultPtr withHierarchy(const ShowResult &textResult, const juce::String &tree)
+    {
+        ShowResult result = textResult;
+        result.embed.fields.emplace_back("Inheritance", ::toCodeBlock("", tree));
+        result.needsGraph = false;
+        result.serialised = sld::json::stringifyObj(result.embed);
+        return std::make_shared<const ShowResult>(std::move(result));
+    }
+    
+    /** Splits results into groups that each fit into one message, as indices into the results. */
+    std::vector<std::vector<std::size_t>> splitIntoMessages(const std::vector<ShowCache::ResultPtr> &results)
+    {
+        // Discord caps a message at 10 embeds with 6000 characters in total, anything beyond goes into a follow-up
+        static constexpr std::size_t max_embeds_per_message = 10;
+        static constexpr std::size_t max_embed_characters   = 6000;
+        
+        std::vector<std::vector<std::size_t>> messages(1);
+        std::size_t                           length = 0;
+        
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const std::size_t embed_length = ::getEmbedLength(results[i]->embed);
+            const std::size_t num_embeds   = messages.back().size();
+            
+            if (num_embeds > 0 && (num_embeds == max_embeds_per_message
+                                   || length + embed_length > max_embed_characters))
+            {
+                messages.emplace_back();
+                length = 0;
+            }
+            
+            messages.back().emplace_back(i);
+            length += embed_length;
+        }
+        
+        return messages;
+    }
+    
+    struct MessageData
+    {
+        std::vector<std::string>       embeds;
+        std::vector<juce::File>        graphs;
+        std::vector<RenderPool::Image> owners;
+        std::vector<std::string>       links;
+    };
+    
+    /**
+     *  Collects what goes into one message, without graphs every embed is sent as it was before its graph came.
+     *  Graphs that have been uploaded before are linked to where Discord keeps them, as long as that link still works.
+     */
+    /**
+     *  Gets the graph cache key a graph is uploaded and linked by, from the name of its file.
+     *  Graphs the cache couldn't take are in temporary files, which have a uuid after the key that is left out.
+     */
+    std::string getUploadKey(const juce::String &fileName)
+    {
+        const juce::String name = fileName.upToLastOccurrenceOf(".", false, false);
+        const juce::String uuid = name.getLastCharacters(32);
+        
+        if (name.length() > 33 && name[name.length() - 33] == '-' && uuid.containsOnly("0123456789abcdef"))
+        {
+            return name.dropLastCharacters(33).toStdString();
+        }
+        
+        return name.toStdString();
+    }
+    
+    // Discord refuses a link it won't take with a bad request about an embed's image. Anything else, like being rate
+    // limited or not being allowed to post, has nothing to do with the links and would just fail again.
+    bool isLinkRefused(const sld::Response &response)
+    {
+        return response.statusCode == sld::BAD_REQUEST && response.text.find("image") != std::string::npos;
+    }
+    
+    MessageData toMessageData(JuceDocClient &client, const std::vector<ShowCache::ResultPtr> &results,
+                              bool withGraphs)
+    {
+        MessageData data;
+        
+        for (const auto &result_ptr : results)
+        {
+            const ShowResult &result = *result_ptr;
+            
+            if (!result.graph)
+            {
+                data.embeds.emplace_back(result.serialised);
+                data.links.emplace_back();
+                continue;
+            }
+            
+            std::string key = ::getUploadKey(result.graph->getFileName());
+            std::string uploaded_url;
+            
+            if (withGraphs)
+            {
+                uploaded_url = client.getAttachmentCache().find(key);
+                
+                if (uploaded_url.empty())
+                {
+                    data.embeds.emplace_back(result.serialised);
+                    data.graphs.emplace_back(*result.graph);
+                    data.owners.emplace_back(result.graph);
+                    data.links.emplace_back();
+                    continue;
+                }
+            }
+            
+            sld::Embed embed = result.embed;
+            embed.image.url  = uploaded_url;
+            data.embeds.emplace_back(sld::json::stringifyObj(embed));
+            data.links.emplace_back(uploaded_url.empty() ? std::string() : std::move(key));
+        }
+        
+        return data;
+    }
+    
+    std::vector<ShowCache::ResultPtr> pick(const std::vector<ShowCache::ResultPtr> &results,
+                                           const std::vector<std::size_t> &indices)
+    {
+        std::vector<ShowCache::ResultPtr> picked;
+        picked.reserve(indices.size());
+        
+        for (const auto &i : indices)
+        {
+            picked.emplace_back(results[i]);
+        }
+        
+        return picked;
+    }
+    
+    /**
+     *  Sends or edits in the results, with their graphs.
+     *  A graph that was linked to is uploaded again if Discord refused the link or couldn't fetch it.
+     */
+    void sendMessageData(JuceDocClient &client, const sld::Snowflake<sld::Channel> &channelId,
+                         const sld::Snowflake<sld::Message> *messageId, const std::string &content,
+                         std::vector<ShowCache::ResultPtr> results, bool retryLinks = true)
+    {
+        MessageData data = ::toMessageData(client, results, true);
+        
+        if (std::all_of(data.links.begin(), data.links.end(), [](auto &&link) { return link.empty(); }))
+        {
+            retryLinks = false;
+        }
+        
+        // The files have to stay around until the upload is done, releasing them afterwards lets the graph cache
+        // evict them again, or deletes them if they were only temporary
+        auto on_sent = [&client, channelId, content, retryLinks,
+                        message_id = (messageId ? std::make_optional(*messageId) : std::nullopt),
+                        results    = std::move(results),
+                        links      = std::move(data.links),
+                        owners     = std::move(data.owners)](sld::Response response) mutable
+        {
+            owners.clear();
+            
+            if (response.error())
+            {
+                if (retryLinks && ::isLinkRefused(response))
+                {
+                    for (const auto &link : links)
+                    {
+                        client.getAttachmentCache().forget(link);
+                    }
+                    
+                    ::sendMessageData(client, channelId, (message_id ? &*message_id : nullptr), content,
+                                      std::move(results), false);
+                }
+                
+                return;
+            }
+            
+            // Uploaded graphs are named after their graph cache key, which is what their links are remembered by
+            const sld::Message sent = sld::ObjectResponse<sld::Message>(response);
+            
+            for (const auto &attachment : sent.attachments)
+            {
+                client.getAttachmentCache().remember(::getUploadKey(attachment.filename), attachment.url);
+            }
+            
+            if (!retryLinks)
+            {
+                return;
+            }
+            
+            // Discord takes links it can't fetch without complaining, their embeds just come back without an image size
+            bool any_dead = false;
+            
+            for (std::size_t i = 0; i < links.size() && i < sent.embeds.size(); ++i)
+            {
+                if (!links[i].empty() && sent.embeds[i].image.width <= 0)
+                {
+                    client.getAttachmentCache().forget(links[i]);
+                    any_dead = true;
+                }
+            }
+            
+            if (any_dead)
+            {
+                ::sendMessageData(client, sent.channelID, &sent.ID, content, std::move(results), false);
+            }
+        };
+        
+        if (messageId)
+        {
+            client.editSerialisedEmbeds(channelId, *messageId, content, data.embeds, data.graphs, std::move(on_sent));
+        }
+        else
+        {
+            client.sendSerialisedEmbeds(channelId, content, data.embeds, data.graphs, std::move(on_sent));
+        }
+    }
+    
+    void sendShowResults(JuceDocClient &client, const sld::Snowflake<sld::Channel> &channelId,
+                         const juce::String &notices, const std::vector<ShowCache::ResultPtr> &results)
+    {
+        std::string content = ::toMessageContent(notices);
+        
+        for (const auto &indices : ::splitIntoMessages(results))
+        {
+            ::sendMessageData(client, channelId, nullptr, content, ::pick(results, indices));
+            content.clear();
+        }
+    }
+    
+    /**
+     *  Sends the text of all results right away and edits the graphs in once they have been rendered, so nobody has
+     *  to wait for Graphviz to see what they asked for.
+     *  Messages whose results are complete already are sent in one go.
+     */
+    void sendShowResultsInPhases(JuceDocClient &client, const sld::Snowflake<sld::Channel> &channelId,
+                                 const juce::String &notices, const std::vector<const SymbolIndex::Entity*> &entities,
+                                 const std::vector<ShowCache::ResultPtr> &results, QueryBudget(*createBudget)(),
+                                 GraphLimits limits)
+    {
+        // The budget starts once the first message went through, Discord's round-trip isn't the renderer's time
+        struct SharedBudget
+        {
+            std::once_flag started;
+            QueryBudget    budget;
+        };
+        
+        struct Phase
+        {
+            std::vector<const SymbolIndex::Entity*> entities;
+            std::vector<ShowCache::ResultPtr>       results;
+            std::string                             content;
+            std::atomic<std::size_t>                remaining;
+        };
+        
+        auto        shared_budget = std::make_shared<SharedBudget>();
+        std::string content       = ::toMessageContent(notices);
+        
+        for (const auto &indices : ::splitIntoMessages(results))
+        {
+            auto phase       = std::make_shared<Phase>();
+            phase->results   = ::pick(results, indices);
+            phase->content   = content;
+            phase->remaining = indices.size();
+            
+            content.clear();
+            
+            if (std::none_of(phase->results.begin(), phase->results.end(), [](auto &&r) { return r->needsGraph; }))
+            {
+                ::sendMessageData(client, channelId, nullptr, phase->content, phase->results);
+                continue;
+            }
+            
+            for (const auto &i : indices)
+            {
+                phase->entities.emplace_back(entities[i]);
+            }
+            
+            const MessageData text = ::toMessageData(client, phase->results, false);
+            
+            client.sendSerialisedEmbeds(channelId, phase->content, text.embeds, {},
+                                        [&client, phase, shared_budget, createBudget, limits](sld::Response response)
+            {
+                if (response.error())
+                {
+                    JD_DBG("Error sending message: " + response.text);
+                    return;
+                }
+                
+                std::call_once(shared_budget->started, [&shared_budget, createBudget]()
+                {
+                    shared_budget->budget = createBudget();
+                });
+                
+                const sld::Message sent   = sld::ObjectResponse<sld::Message>(response);
+                const QueryBudget  budget = shared_budget->budget;
+                
+                for (std::size_t i = 0; i < phase->entities.size(); ++i)
+                {
+                    CommandShow::completeResult(client, *phase->entities[i], phase->results[i], budget,
+                                                [&client, phase, sent, i](ShowCache::ResultPtr result)
+                    {
+                        phase->results[i] = std::move(result);
+                        
+                        if (phase->remaining.fetch_sub(1) == 1)
+                        {
+                            ::sendMessageData(client, sent.channelID, &sent.ID, phase->content, phase->results);
+                        }
+                    }, limits);
+                }
+            });
+        }
+    }
+    
+    //==================================================================================================================
+    void sendPagedEmbed(const sld::Message &msg, JuceDocClient &client, PagedEmbed embed, const juce::String &title,
+                        std::uint32_t colour)
+    {
+        // Checked before rendering, so a scan finishing in between can only cause one redundant edit.
+        // Navigation only goes on once there's surely more than one page, a scan that ends up with one doesn't get it.
+        const bool       was_complete = embed.isComplete();
+        const bool       has_more     = (embed.getNumItems() > embed.getMaxItemsPerPage());
+        const sld::Embed first_page   = embed.toEmbed(title, colour);
+        
+        client.sendMessage(msg.channelID, "", first_page, {}, sld::TTS::Default, {
+            [&client, embed, sid = msg.serverID, title, colour, was_complete, has_more]
+            (sld::ObjectResponse<sld::Message> response) mutable
+            {
+                if (was_complete && embed.getMaxPages() <= 1)
+                {
+                    return;
+                }
+                
+                if (response.error())
+                {
+                    JD_DBG("Error sending message: " + response.text);
+                    return;
+                }
+                
+                const sld::Message msg = response;
+                const auto add_navigation = [&client, msg]()
+                {
+                    client.addReaction(msg.channelID, msg.ID, PagedEmbed::emoteLastPage.data());
+                    client.addReaction(msg.channelID, msg.ID, PagedEmbed::emoteNextPage.data());
+                };
+                
+                (void) client.applyData<JuceDocClient::EmbedCacheBuffer>(sid, [&embed, &msg](auto &&cache)
+                {
+                    JD_DBG("Added embed to cache for message: '" + msg.ID.string() + "'");
+                    
+                    embed.setMessageId(msg.ID);
+                    cache.push(PagedEmbed(embed));
+                });
+                
+                if (has_more)
+                {
+                    add_navigation();
+                }
+                
+                if (was_complete)
+                {
+                    return;
+                }
+                
+                // Once the scan is done, the page the user is looking at gets updated with the final totals
+                embed.getResults().whenComplete([&client, embed, msg, sid, title, colour, has_more, add_navigation]()
+                {
+                    if (!has_more && embed.getMaxPages() > 1)
+                    {
+                        add_navigation();
+                    }
+                    
+                    sld::Embed final_embed = embed.toEmbed(title, colour);
+                    
+                    (void) client.applyData<JuceDocClient::EmbedCacheBuffer>(sid, [&](auto &&cache)
+                    {
+                        (void) cache.withEmbed(msg.ID, [&](PagedEmbed &cached)
+                        {
+                            final_embed = cached.toEmbed(title, colour);
+                        });
+                    });
+                    
+                    client.editMessage(msg, "", final_embed);
+                });
+            }
+        });
+    }
+    
+    //==================================================================================================================
+    bool executeListCommand(const sld::Message &msg, JuceDocClient &client, const juce::StringArray &args, bool isList,
+                            QueryBudget budget)
     {
         if (!isList && args.isEmpty())
         {
@@ -68,7 +694,7 @@ namespace
             return true;
         }
     
-        PagedEmbed embed(msg.channelID, filter);
+        PagedEmbed embed(msg.channelID, client.getIndex(), filter);
         embed.setMaxItemsPerPage(5);
     
         juce::String  title;
@@ -76,179 +702,369 @@ namespace
     
         if (isList)
         {
-            embed.applyListWithFilter(client.getCache(), "");
             title  = "Entity List";
             colour = Colours::List;
         }
         else
         {
-            embed.applyListWithFilter(client.getCache(), query);
             title  = "Symbols found for: " + query;
             colour = Colours::Find;
         }
     
         JD_DBG("Generating embed with filters: " + filter.toString().toStdString());
         
-        client.sendMessage(msg.channelID, "", embed.toEmbed(title, colour), {}, sld::TTS::Default, {
-            [&client, embed, sid = msg.serverID](sld::ObjectResponse<sld::Message> response) mutable
-            {
-                if (embed.getMaxPages() <= 1)
-                {
-                    return;
-                }
-            
-                if (response.error())
-                {
-                    JD_DBG("Error sending message: " + response.text);
-                    return;
-                }
+        if (AppConfig::getInstance().streamResults)
+        {
+            // Everyone asking the same while the scan is running gets the same results, each with their own message
+            const std::string flight_key = (isList ? "list\n" : "find\n" + query.toStdString() + "\n")
+                                           + filter.toString().toStdString();
             
-                const sld::Message msg = response;
-                (void) client.applyData<JuceDocClient::EmbedCacheBuffer>(sid, [&client, &embed, &msg](auto &&cache)
+            // The scan keeps going in the background and the flight with it, until the last result is in
+            embed.shareResults(listFlights.launch(flight_key, [&client, &embed, &query, &budget, &flight_key]()
+            {
+                embed.getResults().whenComplete([flight_key]() { listFlights.land(flight_key); });
+                client.getWorkerPool().addJob([scan = embed, query, budget]() mutable
                 {
-                    JD_DBG("Added embed to cache for message: '" + msg.ID.string() + "'");
-                
-                    embed.setMessageId(msg.ID);
-                    cache.push(std::move(embed));
-                
-                    client.addReaction(msg.channelID, msg.ID, PagedEmbed::emoteLastPage.data());
-                    client.addReaction(msg.channelID, msg.ID, PagedEmbed::emoteNextPage.data());
+                    scan.applyListWithFilter(query, budget);
                 });
-            }
-        });
+                
+                return embed.getSharedResults();
+            }));
+            
+            // The first page goes out as soon as it has been filled
+            (void) embed.getResults().waitFor(static_cast<std::size_t>(embed.getMaxItemsPerPage()));
+        }
+        else
+        {
+            embed.applyListWithFilter(query, budget);
+        }
         
+        ::sendPagedEmbed(msg, client, std::move(embed), title, colour);
         return true;
     }
 }
 
+// CommandBase
+//======================================================================================================================
+QueryBudget CommandBase::createBudget()
+{
+    const AppConfig &config = AppConfig::getInstance();
+    return { config.queryTimeMs, config.queryWork };
+}
+
 // CommandList
 //======================================================================================================================
 bool CommandList::execute(const sld::Message &msg, const juce::StringArray &args)
 {
-    return ::executeListCommand(msg, client, args, true);
+    return ::executeListCommand(msg, client, args, true, createBudget());
 }
 
 // CommandFind
 //======================================================================================================================
 bool CommandFind::execute(const sld::Message &msg, const juce::StringArray &args)
 {
-    return ::executeListCommand(msg, client, args, false);
+    return ::executeListCommand(msg, client, args, false, createBudget());
 }
 
 // CommandShow
 //======================================================================================================================
 bool CommandShow::execute(const sld::Message &msg, const juce::StringArray &args)
 {
-    if (args.size() != 1)
+    // The configured limits are also the most anyone can ask for, a request can only make its graphs smaller
+    GraphLimits       limits = GraphLimits::getDefault();
+    juce::StringArray queries;
+    juce::String      notices;
+    
+    for (const auto &arg : args)
+    {
+        if (arg.equalsIgnoreCase("graph:text"))
+        {
+            limits.textOnly = true;
+        }
+        else if (!::parseGraphLimit(arg, "depth:", limits.depth, notices)
+                 && !::parseGraphLimit(arg, "width:", limits.width, notices))
+        {
+            queries.add(arg);
+        }
+    }
+    
+    if (queries.isEmpty() || queries.size() > maxSymbols)
     {
         return false;
     }
     
-    const juce::String     &query = args.getReference(0);
-    const EntityDefinition def    = EntityDefinition::createFromSymbolPath(query, client.getCache());
+    const SymbolIndex                       &index = client.getIndex();
+    std::vector<const SymbolIndex::Entity*> entities;
+    
+    for (const auto &query : queries)
+    {
+        const SymbolIndex::Lookup lookup = index.resolve(query);
+        
+        if (lookup.match)
+        {
+            if (std::find(entities.begin(), entities.end(), lookup.match) == entities.end())
+            {
+                index.recordQuery(lookup.match->id);
+                
+                if (client.getQueryLog().record(lookup.match->qualifiedName))
+                {
+                    // The gateway thread would otherwise be stuck writing the file instead of reading messages
+                    client.getWorkerPool().addJob([&client]() { client.getQueryLog().save(); });
+                }
+                
+                entities.emplace_back(lookup.match);
+            }
+        }
+        else if (!lookup.candidates.empty())
+        {
+            notices << "**" << query << "** is ambiguous, did you mean one of these?\n"
+                    << ::toCandidateList(lookup.candidates) << "\n";
+        }
+        else
+        {
+            notices << "Sorry, I could not find any entity for: " << query << ". :/\n";
+        }
+    }
     
-    if (!def)
+    if (entities.empty())
     {
-        client.sendMessage(msg.channelID, "Sorry, I could not find any entity for: " + query.toStdString() + ". :/");
+        client.sendMessage(msg.channelID, ::toMessageContent(notices));
         return true;
     }
     
-    const AppConfig    &config = AppConfig::getInstance();
-    const juce::String doc_url = AppInfo::urlJuceDocsBase.data() + config.branchName + "/";
-    const EntityType   type    = def.getType();
+    // The message is sent by whoever finishes last, this thread or the render pool, so nothing here has to wait
+    struct PendingShow
+    {
+        std::vector<ShowCache::ResultPtr> results;
+        juce::String                      notices;
+        std::atomic<std::size_t>          remaining;
+    };
     
-    sld::Embed embed;
-    embed.color          = Colours::Show;
-    embed.author.iconUrl = AppIcon::values[type->ordinal()]->getUrl();
-    embed.author.name    = type->name();
-    embed.title          = def->name().str() + (type == EntityType::Function ? "()" : "");
-    embed.url            = (doc_url + getUrlFromEntity(type, *def)).toRawUTF8();
-    embed.description    = def.getDocumentation().toRawUTF8();
-    embed.timestamp      = config.currentCommit.date.toStdString();
-    embed.footer.iconUrl = AppIcon::LogoGitHub.getUrl();
-    embed.footer.text    = config.currentCommit.name.substring(0, 9).toStdString()
-                           + " (" + config.branchName.toStdString() + ")";
+    auto pending       = std::make_shared<PendingShow>();
+    pending->notices   = notices;
+    pending->remaining = entities.size();
+    pending->results.resize(entities.size());
+    
+    ::runParallel(client.getWorkerPool(), entities.size(), [&](std::size_t i)
+    {
+        pending->results[i] = fetchResult(client, *entities[i]);
+    });
     
-    if (const juce::String definition = def.getDefinition().toStdString(); !definition.isEmpty())
+    // All graphs share one budget, so asking for several at once can't take longer than asking for one
+    if (AppConfig::getInstance().twoPhaseShow && !limits.textOnly)
     {
-        embed.fields.emplace_back("Definition", ::toCodeBlock("cpp", definition));
+        ::sendShowResultsInPhases(client, msg.channelID, notices, entities, pending->results, &createBudget, limits);
+        return true;
     }
     
-    embed.fields.emplace_back("Details", ::toCodeBlock("yaml", "Path:   " + def->qualifiedName().str()     + "\n"
-                                                               + "Module: " + def.getModule().toStdString()  + "\n"
-                                                               + "Parent: " + def.getParent().toStdString()));
+    const QueryBudget budget = createBudget();
     
-    if (type == EntityType::Function)
+    for (std::size_t i = 0; i < entities.size(); ++i)
     {
-        if (const auto *commands = def.getCommands(EntityDefinition::CommandIds::param); commands)
+        completeResult(client, *entities[i], pending->results[i], budget,
+                       [&client, pending, channel_id = msg.channelID, i](ShowCache::ResultPtr result)
         {
-            juce::String param_list;
+            pending->results[i] = std::move(result);
             
-            for (const auto &[name, val] : *commands)
+            if (pending->remaining.fetch_sub(1) == 1)
             {
-                param_list << name << ": " << val << "\n";
+                ::sendShowResults(client, channel_id, pending->notices, pending->results);
             }
-            
-            embed.fields.emplace_back("Parameters", ::toCodeBlock("yaml", param_list));
-        }
+        }, limits);
     }
-    else if (type == EntityType::Enum)
+    
+    return true;
+}
+
+ShowCache::ResultPtr CommandShow::fetchResult(JuceDocClient &client, const SymbolIndex::Entity &entity)
+{
+    ShowCache           &cache = client.getShowCache();
+    const std::uint64_t key    = ShowCache::makeKey(entity.id, AppConfig::getInstance().currentCommit.name);
+    
+    if (ShowCache::ResultPtr cached = cache.get(key))
+    {
+        return cached;
+    }
+    
+    auto result = std::make_shared<const ShowResult>(::createShowResult(client, entity));
+    (void) cache.put(key, result);
+    return result;
+}
+
+void CommandShow::completeResult(JuceDocClient &client, const SymbolIndex::Entity &entity, ShowCache::ResultPtr result,
+                                 QueryBudget budget, std::function<void(ShowCache::ResultPtr)> callback,
+                                 GraphLimits limits)
+{
+    if (!result->needsGraph)
     {
-        const MemberDef *const member = static_cast<const MemberDef*>(def.get());
+        callback(std::move(result));
+        return;
+    }
+    
+    const SymbolIndex &index = client.getIndex();
+    
+    const auto as_text = [&index, &entity, limits](const ShowResult &textResult)
+    {
+        return ::withHierarchy(textResult, ::toHierarchyTree(index, entity.id, limits));
+    };
+    
+    // Text takes no time at all, it's used when asked for or when the graph wouldn't make it in time anyway
+    if (limits.textOnly || client.getRenderPool().getEstimatedWaitMs() > budget.getRemainingMs())
+    {
+        callback(as_text(*result));
+        return;
+    }
+    
+    const std::uint64_t key = ShowCache::makeKey(entity.id, AppConfig::getInstance().currentCommit.name);
+    
+    // Only graphs with the usual limits are what the next request for the same entity will want too
+    const bool is_default = (limits == GraphLimits::getDefault());
+    
+    const auto finish = [&client, result, budget, callback, key, is_default, as_text]
+                        (const RenderPool::Image &graph) mutable
+    {
+        ShowCache::ResultPtr finished;
         
-        if (const MemberList &enumerators = member->enumFieldList(); !enumerators.empty())
+        if (graph)
         {
-            juce::String enum_list;
+            finished = ::withGraph(*result, graph);
             
-            for (const auto &enumerator : member->enumFieldList())
+            if (is_default)
             {
-                enum_list << enumerator->name().data() << ": "
-                          << (enumerator->hasBriefDescription() ? enumerator->briefDescription()
-                                                                : enumerator->documentation()).data() << "\n";
+                (void) client.getShowCache().put(key, finished);
             }
-            
-            embed.fields.emplace_back("Enumerators", ::toCodeBlock("yaml", enum_list));
         }
-    }
-    
-    if (const auto *examples = def.getCommands(EntityDefinition::CommandIds::code); examples)
-    {
-        juce::String example_list;
-        
-        for (int i = 0; i < examples->size(); ++i)
+        else if (budget.isExhausted())
+        {
+            // A result that ran out of time gets the text version instead, it's sent but not kept
+            finished = as_text(*result);
+        }
+        else
         {
-            example_list << "Example " << (i + 1) << ::toCodeBlock("cpp", (*examples)[i].value);
+            finished = std::move(result);
         }
         
-        embed.fields.emplace_back("Examples", example_list.toStdString());
+        // Sending blocks for the whole request, that's not something the render thread should wait for
+        client.getWorkerPool().addJob([callback, finished]() mutable
+        {
+            callback(std::move(finished));
+        });
+    };
+    
+    if (!submitGraph(client, entity, budget, finish, limits))
+    {
+        callback(as_text(*result));
+    }
+}
+
+std::string CommandShow::getGraphKey(const SymbolIndex::Entity &entity, GraphLimits limits)
+{
+    // The limits are always part of it, images rendered before the defaults changed must not come up again
+    return GraphCache::makeKey(AppConfig::getInstance().currentCommit.name, entity.qualifiedName)
+           + "-d" + std::to_string(limits.depth) + "w" + std::to_string(limits.width);
+}
+
+bool CommandShow::submitGraph(JuceDocClient &client, const SymbolIndex::Entity &entity, QueryBudget budget,
+                              RenderPool::Callback callback, GraphLimits limits)
+{
+    const std::string key = getGraphKey(entity, limits);
+    
+    // Graphs rendered before, even before a restart, don't have to queue up behind the ones that still need drawing
+    if (RenderPool::Image image = client.getGraphCache().find(key))
+    {
+        callback(image);
+        return true;
     }
     
-    if (const auto *references = def.getCommands(EntityDefinition::CommandIds::see); references)
+    const auto render = [&client, &entity, budget, key, limits]() -> RenderPool::Image
     {
-        juce::String reference_list;
+        const juce::MemoryBlock image = InheritanceGraph::render(client.getIndex(), entity.id, limits, budget);
+        
+        if (image.isEmpty())
+        {
+            return nullptr;
+        }
         
-        for (const auto &[_, name] : *references)
+        if (RenderPool::Image cached = client.getGraphCache().store(key, image))
         {
-            reference_list << name << ", ";
+            return cached;
         }
         
-        embed.fields.emplace_back("See also", reference_list.trimCharactersAtEnd(", ").toStdString());
+        // Uploads can only be made from files, so if the cache can't take it the image still has to go somewhere.
+        // Every render gets a file of its own, nothing another request sends or deletes can be written over.
+        const juce::File file = client.getDirTemp().getChildFile(key + "-" + juce::Uuid().toString() + ".jpg");
+        return (file.replaceWithData(image.getData(), image.getSize()) ? ::toTemporaryFile(file) : nullptr);
+    };
+    
+    return client.getRenderPool().submit(key, render, std::move(callback));
+}
+
+// CommandSuggest
+//======================================================================================================================
+bool CommandSuggest::execute(const SleepyDiscord::Message &msg, const juce::StringArray &args)
+{
+    if (args.isEmpty() || args.size() > 2)
+    {
+        return false;
     }
     
-    const juce::File &dir_temp = client.getDirTemp();
+    const int count = (args.size() > 1 ? args[1].getIntValue() : AppInfo::defaultSuggestions);
     
-    if (const juce::File cs_file = def.generateGraph(dir_temp, dir_temp); !cs_file.getFullPathName().isEmpty())
+    if (count < 1 || count > static_cast<int>(PrefixTrie::maxResults))
     {
-        embed.image.url = "attachment://" + cs_file.getFileName().toStdString();
-        (void) client.uploadFile(msg.channelID, cs_file.getFullPathName().toStdString(), "", embed, {}, {
-            [cs_file](auto&&) { (void) cs_file.deleteFile(); }
-        });
+        return false;
     }
-    else
+    
+    const std::vector<const SymbolIndex::Entity*> suggestions = client.getIndex().suggest(args[0], count);
+    
+    if (suggestions.empty())
     {
-        (void) client.sendMessage(msg.channelID, "", embed);
+        client.sendMessage(msg.channelID, "Sorry, I don't know any symbol starting with: "
+                                          + args[0].toStdString() + ". :/");
+        return true;
     }
     
+    sld::Embed embed;
+    embed.title       = "Suggestions for: " + args[0].toStdString();
+    embed.color       = Colours::Sugg;
+    embed.description = ::toCandidateList(suggestions).toStdString();
+    
+    client.sendMessage(msg.channelID, "", embed);
+    return true;
+}
+
+// CommandSearch
+//======================================================================================================================
+bool CommandSearch::execute(const SleepyDiscord::Message &msg, const juce::StringArray &args)
+{
+    if (args.isEmpty())
+    {
+        return false;
+    }
+    
+    const juce::String query = args.joinIntoString(" ");
+    const std::vector<DocumentIndex::Hit> hits = client.getDocumentIndex().search(query.toStdString(), maxResults);
+    
+    if (hits.empty())
+    {
+        client.sendMessage(msg.channelID, "Sorry, I couldn't find anything in the docs about: "
+                                          + query.toStdString() + ". :/");
+        return true;
+    }
+    
+    std::vector<SymbolIndex::EntityId> ids;
+    ids.reserve(hits.size());
+    
+    for (const auto &hit : hits)
+    {
+        ids.emplace_back(hit.id);
+    }
+    
+    PagedEmbed embed(msg.channelID, client.getIndex());
+    embed.setMaxItemsPerPage(5);
+    embed.applyResults(ids);
+    
+    ::sendPagedEmbed(msg, client, std::move(embed), "Search results for: " + query, Colours::Srch);
     return true;
 }
 
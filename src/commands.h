@@ -2,6 +2,9 @@
 #pragma once
 
 #include "commandbase.h"
+#include "inheritancegraph.h"
+#include "renderpool.h"
+#include "showcache.h"
 
 #include <juce_core/juce_core.h>
 #include <sleepy_discord/sleepy_discord.h>
@@ -11,3 +14,5 @@
 #include "commands/commandshow.h"
 #include "commands/commandabout.h"
 #include "commands/commandfilters.h"
+#include "commands/commandsuggest.h"
+#include "commands/commandsearch.h"
@@ -0,0 +1,26 @@
+
+#pragma once
+
+class CommandSearch : public CommandBase
+{
+public:
+    static constexpr std::size_t maxResults = 50;
+    
+    //==================================================================================================================
+    using CommandBase::CommandBase;
+    
+    //==================================================================================================================
+    std::string_view getName() const noexcept override { return "Search"; }
+    
+    std::string_view getDescription() const noexcept override
+    {
+        return "Searches the documentation text of all symbols for the given words, best matches first.";
+    }
+    
+    std::string_view getEmoteName()   const noexcept override { return "mag"; }
+    std::string_view getUsage()       const noexcept override { return "search <words...>"; }
+    std::string_view getPermission()  const noexcept override { return "cmd.user.search";  }
+    
+    //==================================================================================================================
+    bool execute(const SleepyDiscord::Message &msg, const juce::StringArray &args) override;
+};
@@ -4,6 +4,9 @@
 class CommandShow : public CommandBase
 {
 public:
+    static constexpr int maxSymbols = 10;
+    
+    //==================================================================================================================
     using CommandBase::CommandBase;
     
     //==================================================================================================================
@@ -11,13 +14,36 @@ public:
     
     std::string_view getDescription() const noexcept override
     {
-        return "Tries to find a certain symbol and gives a detailed overview if it was found.";
+        return "Tries to find one or more symbols and gives a detailed overview of each one that was found.";
+    }
+    
+    std::string_view getUsage() const noexcept override
+    {
+        return "show <symbol-path> [symbol-path...] [depth:<levels>] [width:<classes>] [graph:text]";
     }
     
     std::string_view getEmoteName()   const noexcept override { return "symbols"; }
-    std::string_view getUsage()       const noexcept override { return "find <symbol-path>"; }
     std::string_view getPermission()  const noexcept override { return "cmd.user.show";  }
     
     //==================================================================================================================
     bool execute(const SleepyDiscord::Message &msg, const juce::StringArray &args) override;
+    
+    //==================================================================================================================
+    /** Gets the rendered result for an entity from the cache, or renders and caches it without its graph. */
+    static ShowCache::ResultPtr fetchResult(JuceDocClient &client, const SymbolIndex::Entity &entity);
+    
+    /**
+     *  Hands the graph of a result that still needs one to the render pool and calls back with the finished result.
+     *  Results that are complete already are passed straight to the callback.
+     */
+    static void completeResult(JuceDocClient &client, const SymbolIndex::Entity &entity, ShowCache::ResultPtr result,
+                               QueryBudget budget, std::function<void(ShowCache::ResultPtr)> callback,
+                               GraphLimits limits = GraphLimits::getDefault());
+    
+    /** Gets the name a graph is kept under in the graph cache, which depends on everything it was rendered with. */
+    static std::string getGraphKey(const SymbolIndex::Entity &entity, GraphLimits limits = GraphLimits::getDefault());
+    
+    /** Gets the graph of a class from the graph cache, or queues it up for rendering, false if the queue is full. */
+    static bool submitGraph(JuceDocClient &client, const SymbolIndex::Entity &entity, QueryBudget budget,
+                            RenderPool::Callback callback, GraphLimits limits = GraphLimits::getDefault());
 };
@@ -0,0 +1,23 @@
+
+#pragma once
+
+class CommandSuggest : public CommandBase
+{
+public:
+    using CommandBase::CommandBase;
+    
+    //==================================================================================================================
+    std::string_view getName() const noexcept override { return "Suggest"; }
+    
+    std::string_view getDescription() const noexcept override
+    {
+        return "Suggests symbol names that start with the given text, most relevant first.";
+    }
+    
+    std::string_view getEmoteName()   const noexcept override { return "pencil"; }
+    std::string_view getUsage()       const noexcept override { return "suggest <prefix> [count]"; }
+    std::string_view getPermission()  const noexcept override { return "cmd.user.suggest";  }
+    
+    //==================================================================================================================
+    bool execute(const SleepyDiscord::Message &msg, const juce::StringArray &args) override;
+};
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <array>
 #include <string_view>
 #include <juce_core/juce_core.h>
 
@@ -11,8 +12,30 @@ struct AppInfo
     static constexpr std::string_view urlJuceGitRepo  = "https://github.com/juce-framework/JUCE";
     static constexpr std::string_view urlJuceDocsBase = "https://docs.juce.com/";
     static constexpr std::string_view nameLogger      = "Main";
+    static constexpr std::string_view nameIndexer     = "jucedoc-indexer";
     
     static constexpr int              defaultPageCacheSize = 30;
+    static constexpr int              defaultSuggestions   = 5;
+    static constexpr int              defaultQueryTimeMs   = 3000;
+    static constexpr int              defaultQueryWork     = 2000000;
+    static constexpr int              defaultGuildRate     = 60;
+    static constexpr int              defaultGuildBurst    = 20;
+    static constexpr int              defaultUserRate      = 12;
+    static constexpr int              defaultUserBurst     = 4;
+    static constexpr int              defaultShowCacheMiB  = 16;
+    static constexpr int              defaultWarmUpCount   = 25;
+    static constexpr int              defaultWarmUpTimeMs  = 15000;
+    static constexpr int              defaultGraphQueue    = 32;
+    static constexpr int              defaultGraphCacheMiB = 256;
+    static constexpr int              defaultGraphDepth    = 3;
+    static constexpr int              defaultGraphWidth    = 8;
+    
+    // Shown first after a restart if nothing has been asked for yet
+    static constexpr std::array<std::string_view, 12> coreClasses {
+        "juce::String", "juce::Component", "juce::AudioBuffer", "juce::AudioProcessor", "juce::ValueTree",
+        "juce::File", "juce::Array", "juce::Graphics", "juce::Slider", "juce::Timer", "juce::MidiBuffer",
+        "juce::AudioProcessorValueTreeState"
+    };
     static constexpr std::string_view defaultBranch        = "develop";
 };
 
@@ -37,6 +60,26 @@ public:
     juce::String branchName    { AppInfo::defaultBranch.data() };
     int          pageCacheSize { AppInfo::defaultPageCacheSize };
     bool         cloneOnStart  { false };
+    bool         streamResults { false };
+    int          queryTimeMs   { AppInfo::defaultQueryTimeMs };
+    int          queryWork     { AppInfo::defaultQueryWork };
+    int          guildRate     { AppInfo::defaultGuildRate };
+    int          guildBurst    { AppInfo::defaultGuildBurst };
+    int          userRate      { AppInfo::defaultUserRate };
+    int          userBurst     { AppInfo::defaultUserBurst };
+    int          showCacheMiB  { AppInfo::defaultShowCacheMiB };
+    int          warmUpCount   { AppInfo::defaultWarmUpCount };
+    int          warmUpTimeMs  { AppInfo::defaultWarmUpTimeMs };
+    int          graphQueue    { AppInfo::defaultGraphQueue };
+    int          graphCacheMiB { AppInfo::defaultGraphCacheMiB };
+    int          graphDepth    { AppInfo::defaultGraphDepth };
+    int          graphWidth    { AppInfo::defaultGraphWidth };
+    bool         preRender     { false };
+    bool         twoPhaseShow  { false };
+    bool         fullParse     { false };
+    juce::String fingerprints;
+    int          parseThreads  { 1 };
+    bool         useIndexer    { false };
 };
 
 struct Colours
@@ -48,7 +91,9 @@ struct Colours
         Show  = 0xCC99C9,
         Help  = 0x9EE09E,
         Fail  = 0xFF6663,
-        About = 0xFEB144
+        About = 0xFEB144,
+        Sugg  = 0xB5EAD7,
+        Srch  = 0xC7CEEA
     };
 };
 
@@ -0,0 +1,383 @@
+
+#include "documentindex.h"
+
+// Doxygen
+#include <definition.h>
+// STL
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+
+namespace
+{
+    // Names count more than words somewhere in the documentation
+    constexpr std::uint32_t nameWeight = 3;
+    
+    constexpr std::array<std::string_view, 32> stopWords {
+        "a", "an", "and", "are", "as", "at", "be", "by", "can", "for", "from", "if", "in", "into", "is", "it", "of",
+        "on", "or", "that", "the", "this", "to", "will", "with", "you", "param", "returns", "see", "code", "endcode",
+        "juce"
+    };
+    
+    //==================================================================================================================
+    bool isStopWord(std::string_view word)
+    {
+        return std::find(stopWords.begin(), stopWords.end(), word) != stopWords.end();
+    }
+    
+    bool endsWith(const std::string &word, std::string_view suffix)
+    {
+        return word.size() >= suffix.size() && word.compare(word.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+    
+    std::string stem(std::string word)
+    {
+        // Deliberately light, it only has to map the usual inflections onto the same term.
+        // Plurals follow the first step of Porter's, "classes" becomes "class" and "class" or "address" are left alone.
+        if (::endsWith(word, "sses"))
+        {
+            word.resize(word.size() - 2);
+            return word;
+        }
+        
+        if (!::endsWith(word, "ss"))
+        {
+            for (const std::string_view suffix : { "ing", "ed", "es", "s" })
+            {
+                if (word.size() >= suffix.size() + 3 && ::endsWith(word, suffix))
+                {
+                    word.resize(word.size() - suffix.size());
+                    break;
+                }
+            }
+        }
+        
+        if (word.size() >= 4 && word.back() == 'e')
+        {
+            word.pop_back();
+        }
+        
+        return word;
+    }
+    
+    //==================================================================================================================
+    void writeVarInt(std::vector<std::uint8_t> &output, std::uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            output.emplace_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        
+        output.emplace_back(static_cast<std::uint8_t>(value));
+    }
+    
+    // Returns false instead of reading past the end, or past the five bytes a 32 bit value can take up
+    bool readVarInt(const std::uint8_t *&data, const std::uint8_t *end, std::uint32_t &value)
+    {
+        value = 0;
+        
+        for (int shift = 0; shift < 35 && data < end; shift += 7)
+        {
+            const std::uint8_t byte = *data++;
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            
+            if (!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    //==================================================================================================================
+    void addTokens(std::unordered_map<std::string, std::uint32_t> &frequencies, std::string_view text,
+                   std::uint32_t weight, std::uint32_t &length)
+    {
+        for (auto &token : DocumentIndex::tokenise(text))
+        {
+            frequencies[std::move(token)] += weight;
+            length += weight;
+        }
+    }
+}
+
+//**********************************************************************************************************************
+// region DocumentIndex
+//======================================================================================================================
+std::vector<std::string> DocumentIndex::tokenise(std::string_view text)
+{
+    std::vector<std::string> tokens;
+    
+    const auto add_token = [&tokens](std::string token)
+    {
+        if (token.size() > 1 && !::isStopWord(token))
+        {
+            tokens.emplace_back(::stem(std::move(token)));
+        }
+    };
+    
+    std::string word;
+    std::string part;
+    bool        was_lower = false;
+    bool        was_split = false;
+    
+    for (std::size_t i = 0; i <= text.size(); ++i)
+    {
+        const unsigned char c = (i < text.size() ? static_cast<unsigned char>(text[i]) : ' ');
+        
+        if (std::isalnum(c))
+        {
+            // Identifiers like AudioBuffer are split into their parts too, so that "audio buffer" finds them
+            if (std::isupper(c) && was_lower)
+            {
+                add_token(part);
+                part.clear();
+                was_split = true;
+            }
+            
+            const char lower = static_cast<char>(std::tolower(c));
+            word.push_back(lower);
+            part.push_back(lower);
+            was_lower = (std::islower(c) != 0);
+            continue;
+        }
+        
+        if (!word.empty())
+        {
+            if (was_split)
+            {
+                add_token(std::move(part));
+            }
+            
+            add_token(std::move(word));
+        }
+        
+        word.clear();
+        part.clear();
+        was_lower = false;
+        was_split = false;
+    }
+    
+    return tokens;
+}
+
+//======================================================================================================================
+void DocumentIndex::build(const SymbolIndex &index)
+{
+    terms.clear();
+    postings.clear();
+    docLengths.assign(index.size(), 0);
+    
+    // Entity ids only ever grow while building, so every posting list comes out sorted
+    std::unordered_map<std::string, std::vector<std::pair<EntityId, std::uint32_t>>> raw_postings;
+    std::unordered_map<std::string, std::uint32_t>                                   frequencies;
+    std::uint64_t                                                                    total_length = 0;
+    
+    for (EntityId id = 0; id < index.size(); ++id)
+    {
+        const Definition &definition = *index.getDefinition(id);
+        std::uint32_t    length      = 0;
+        
+        frequencies.clear();
+        ::addTokens(frequencies, definition.localName().str(),        nameWeight, length);
+        ::addTokens(frequencies, definition.briefDescription().str(), 1,          length);
+        ::addTokens(frequencies, definition.documentation().str(),    1,          length);
+        
+        for (auto &[term, frequency] : frequencies)
+        {
+            raw_postings[term].emplace_back(id, frequency);
+        }
+        
+        docLengths[id] = static_cast<std::uint16_t>(std::min<std::uint32_t>(length, 0xFFFF));
+        total_length  += length;
+    }
+    
+    averageLength = (index.size() > 0 ? static_cast<float>(total_length) / index.size() : 0.0f);
+    terms.reserve(raw_postings.size());
+    
+    for (const auto &[term, list] : raw_postings)
+    {
+        Term &entry        = terms[term];
+        entry.offset       = static_cast<std::uint32_t>(postings.size());
+        entry.docFrequency = static_cast<std::uint32_t>(list.size());
+        
+        EntityId previous = 0;
+        
+        for (const auto &[id, frequency] : list)
+        {
+            ::writeVarInt(postings, id - previous);
+            ::writeVarInt(postings, frequency);
+            previous = id;
+        }
+        
+        entry.length = static_cast<std::uint32_t>(postings.size()) - entry.offset;
+    }
+    
+    postings.shrink_to_fit();
+}
+
+void DocumentIndex::writeTo(juce::OutputStream &output) const
+{
+    (void) output.writeInt(static_cast<int>(terms.size()));
+    
+    for (const auto &[key, term] : terms)
+    {
+        (void) output.writeString(juce::String::fromUTF8(key.data(), static_cast<int>(key.size())));
+        (void) output.writeInt(static_cast<int>(term.offset));
+        (void) output.writeInt(static_cast<int>(term.length));
+        (void) output.writeInt(static_cast<int>(term.docFrequency));
+    }
+    
+    (void) output.writeInt64(static_cast<juce::int64>(postings.size()));
+    (void) output.write(postings.data(), postings.size());
+    (void) output.writeInt(static_cast<int>(docLengths.size()));
+    
+    for (const auto &length : docLengths)
+    {
+        (void) output.writeShort(static_cast<short>(length));
+    }
+    
+    (void) output.writeFloat(averageLength);
+}
+
+bool DocumentIndex::readFrom(juce::InputStream &input, std::size_t numEntities)
+{
+    const auto read_all = [this, &input, numEntities]()
+    {
+        const int num_terms = input.readInt();
+        
+        if (num_terms < 0 || num_terms > input.getNumBytesRemaining())
+        {
+            return false;
+        }
+        
+        terms.reserve(static_cast<std::size_t>(num_terms));
+        
+        for (int i = 0; i < num_terms; ++i)
+        {
+            Term &term        = terms[input.readString().toStdString()];
+            term.offset       = static_cast<std::uint32_t>(input.readInt());
+            term.length       = static_cast<std::uint32_t>(input.readInt());
+            term.docFrequency = static_cast<std::uint32_t>(input.readInt());
+        }
+        
+        const juce::int64 num_bytes = input.readInt64();
+        
+        if (num_bytes < 0 || num_bytes > input.getNumBytesRemaining())
+        {
+            return false;
+        }
+        
+        postings.resize(static_cast<std::size_t>(num_bytes));
+        
+        if (input.read(postings.data(), static_cast<int>(num_bytes)) != num_bytes)
+        {
+            return false;
+        }
+        
+        // Search looks up lengths by entity id, a snapshot with fewer of them would have it read past the end
+        const int num_docs = input.readInt();
+        
+        if (num_docs < 0 || static_cast<std::size_t>(num_docs) != numEntities
+            || num_docs > input.getNumBytesRemaining())
+        {
+            return false;
+        }
+        
+        docLengths.resize(static_cast<std::size_t>(num_docs));
+        
+        for (auto &length : docLengths)
+        {
+            length = static_cast<std::uint16_t>(input.readShort());
+        }
+        
+        averageLength = input.readFloat();
+        
+        // A term pointing outside of the postings would have search read past them
+        return std::all_of(terms.begin(), terms.end(), [this](const auto &entry)
+        {
+            return static_cast<std::uint64_t>(entry.second.offset) + entry.second.length <= postings.size();
+        });
+    };
+    
+    terms.clear();
+    postings.clear();
+    docLengths.clear();
+    
+    if (!read_all())
+    {
+        terms.clear();
+        postings.clear();
+        docLengths.clear();
+        return false;
+    }
+    
+    return true;
+}
+
+//======================================================================================================================
+std::vector<DocumentIndex::Hit> DocumentIndex::search(std::string_view query, std::size_t maxResults) const
+{
+    std::vector<std::string> query_terms = tokenise(query);
+    std::sort(query_terms.begin(), query_terms.end());
+    query_terms.erase(std::unique(query_terms.begin(), query_terms.end()), query_terms.end());
+    
+    const auto num_docs = static_cast<float>(docLengths.size());
+    std::unordered_map<EntityId, float> scores;
+    
+    for (const auto &query_term : query_terms)
+    {
+        const auto it = terms.find(query_term);
+        
+        if (it == terms.end())
+        {
+            continue;
+        }
+        
+        const Term  &term = it->second;
+        const float idf   = std::log(1.0f + (num_docs - term.docFrequency + 0.5f) / (term.docFrequency + 0.5f));
+        
+        const std::uint8_t *data = postings.data() + term.offset;
+        const std::uint8_t *end  = data + term.length;
+        EntityId            id   = 0;
+        std::uint32_t       gap;
+        std::uint32_t       count;
+        
+        while (data < end && ::readVarInt(data, end, gap) && ::readVarInt(data, end, count))
+        {
+            id += gap;
+            
+            if (id >= docLengths.size())
+            {
+                break;
+            }
+            
+            const auto  frequency = static_cast<float>(count);
+            const float norm      = k1 * (1.0f - b + b * docLengths[id] / averageLength);
+            scores[id] += idf * (frequency * (k1 + 1.0f)) / (frequency + norm);
+        }
+    }
+    
+    std::vector<Hit> hits;
+    hits.reserve(scores.size());
+    
+    for (const auto &[id, score] : scores)
+    {
+        hits.push_back(Hit{ id, score });
+    }
+    
+    const std::size_t count = std::min(maxResults, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + count, hits.end(), [](const Hit &a, const Hit &c)
+    {
+        return a.score > c.score || (a.score == c.score && a.id < c.id);
+    });
+    
+    hits.resize(count);
+    return hits;
+}
+//======================================================================================================================
+// endregion DocumentIndex
+//**********************************************************************************************************************
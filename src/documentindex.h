@@ -0,0 +1,67 @@
+
+#pragma once
+
+#include "symbolindex.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+//======================================================================================================================
+/**
+ *  An inverted index over the names and documentation of all indexed entities, ranked with BM25.
+ *  Posting lists are stored as variable length encoded gaps between entity ids, followed by the term frequency.
+ */
+class DocumentIndex
+{
+public:
+    using EntityId = SymbolIndex::EntityId;
+    
+    //==================================================================================================================
+    struct Hit
+    {
+        EntityId id;
+        float    score;
+    };
+    
+    //==================================================================================================================
+    static std::vector<std::string> tokenise(std::string_view text);
+    
+    //==================================================================================================================
+    /** Reads the docs from Doxygen's definitions, so this has to be built before the index lets go of them. */
+    void build(const SymbolIndex &index);
+    
+    /**
+     *  Same as SymbolIndex, this reads what writeTo wrote and returns false if the stream doesn't hold that.
+     *  The docs have to be the ones of the given number of entities, the symbol index read alongside has to match.
+     */
+    void writeTo(juce::OutputStream &output) const;
+    bool readFrom(juce::InputStream &input, std::size_t numEntities);
+    
+    //==================================================================================================================
+    std::vector<Hit> search(std::string_view query, std::size_t maxResults) const;
+    
+    //==================================================================================================================
+    std::size_t getNumTerms()        const noexcept { return terms.size();    }
+    std::size_t getNumPostingBytes() const noexcept { return postings.size(); }
+    
+private:
+    struct Term
+    {
+        std::uint32_t offset;
+        std::uint32_t length;
+        std::uint32_t docFrequency;
+    };
+    
+    //==================================================================================================================
+    static constexpr float k1 = 1.2f;
+    static constexpr float b  = 0.75f;
+    
+    //==================================================================================================================
+    std::unordered_map<std::string, Term> terms;
+    std::vector<std::uint8_t>             postings;
+    std::vector<std::uint16_t>            docLengths;
+    float                                 averageLength { 0.0f };
+};
@@ -1,21 +1,16 @@
 
 #include "entitydefinition.h"
 
-#include "linkresolve.h"
-
 // Doxygen
 #include <classdef.h>
-#include <dotclassgraph.h>
 #include <groupdef.h>
 #include <memberdef.h>
-#include <textstream.h>
-// GraphViz
-#include <graphviz/gvc.h>
 // STL
 #include <regex>
 
 namespace
 {
+    //==================================================================================================================
     void reduceDoubleSpacesAndRemoveNewLines(juce::String &input)
     {
         juce::String output;
@@ -300,6 +295,11 @@ EntityDefinition EntityDefinition::createFromSymbolPath(const juce::String &symb
     return (!def ? EntityDefinition() : EntityDefinition(def, type));
 }
 
+EntityDefinition EntityDefinition::createFromEntity(const Definition &definition, EntityType type)
+{
+    return EntityDefinition(&definition, type);
+}
+
 //======================================================================================================================
 const Definition& EntityDefinition::operator*()  const noexcept { return *definition; }
 const Definition* EntityDefinition::operator->() const noexcept { return definition;  }
@@ -307,59 +307,6 @@ const Definition* EntityDefinition::operator->() const noexcept { return definit
 //======================================================================================================================
 EntityDefinition::operator bool() const noexcept { return definition != nullptr; }
 
-//======================================================================================================================
-juce::File EntityDefinition::generateGraph(const juce::File &inputDir, const juce::File &outputDir) const
-{
-    if (const ClassDef *class_def = dynamic_cast<const ClassDef*>(definition))
-    {
-        if (class_def->baseClasses().empty())
-        {
-            return {};
-        }
-        
-        const juce::String class_name = sanitiseUrl(class_def->qualifiedName().data(), true);
-        const juce::File   dot_file   = inputDir.getChildFile(class_def->compoundTypeString().lower().data()
-                                                              + class_name + "__inherit__graph.dot");
-        
-        if (!dot_file.exists())
-        {
-            TextStream text_stream;
-            DotClassGraph cgraph(class_def, GraphType::Inheritance);
-            cgraph.writeGraph(text_stream, GraphOutputFormat::GOF_BITMAP, EmbeddedOutputFormat::EOF_Html,
-                              inputDir.getFullPathName().toRawUTF8(), "", "");
-        }
-    
-        const juce::File img_file = outputDir.getChildFile(class_name + ".jpg");
-        std::array<char*, 5> gv_args {
-            strdup("dot"), strdup("-Tjpg"), strdup("-Gbgcolor=white"),
-            strdup(dot_file.getFullPathName().toRawUTF8()), strdup(("-o" + img_file.getFullPathName()).toRawUTF8())
-        };
-        
-        std::unique_ptr<GVC_t, void (*)(GVC_t *)> ctx(gvContext(), [](GVC_t *ptr) { gvFreeContext(ptr); });
-        gvParseArgs(ctx.get(), gv_args.size(), gv_args.data());
-        
-        FILE *in = fopen(dot_file.getFullPathName().toRawUTF8(), "r");
-        
-        Agraph_t *const g = agread(in, 0);
-        {
-            gvLayoutJobs(ctx.get(), g);
-            gvRenderJobs(ctx.get(), g);
-            
-            gvFreeLayout(ctx.get(), g);
-            agclose(g);
-        }
-    
-        for (const auto &ptr : gv_args)
-        {
-            free(ptr);
-        }
-    
-        return (img_file.exists() ? img_file : juce::File{});
-    }
-    
-    return {};
-}
-
 //======================================================================================================================
 const EntityDefinition::CommandList* EntityDefinition::getCommands(std::string_view name) const
 {
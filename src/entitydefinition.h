@@ -31,6 +31,7 @@ public:
     //==================================================================================================================
     static EntityDefinition createFromSymbolPath(const juce::String &symbolPath,
                                                  const venum::VenumMap<EntityType, DefVec> &cache);
+    static EntityDefinition createFromEntity(const Definition &definition, EntityType type);
     
     //==================================================================================================================
     const Definition* operator->() const noexcept;
@@ -39,9 +40,6 @@ public:
     //==================================================================================================================
     operator bool() const noexcept;
     
-    //==================================================================================================================
-    juce::File generateGraph(const juce::File &inputDir, const juce::File &outputDir) const;
-    
     //==================================================================================================================
     const CommandList* getCommands(std::string_view name) const;
     
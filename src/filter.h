@@ -61,6 +61,8 @@ public:
                          
                          std::vector<juce::String>,
                          juce::String,
+                         juce::String,
+                         juce::String,
                          Flag,
                          
                          SortType
@@ -96,8 +98,14 @@ public:
                 "The class path each searched entity must begin with.\n"
                 "For example: `list cpath:juce::Audio`, search all entities that start with \"juce::Audio\"."
             },
-            { "constexpr", "Search for entities that are constexpr only. (true/false)" },
-            { "sort",      "Sort the entities after specific criteria."                }
+            {
+                "param",
+                "A type one of the parameters of the searched functions must have, ignoring const, references and "
+                "pointers.\nFor example: `list param:AudioBuffer<float>`, or `list param:AudioBuffer` for any kind."
+            },
+            { "returns",   "The type the searched functions must return, matched like param." },
+            { "constexpr", "Search for entities that are constexpr only. (true/false)"        },
+            { "sort",      "Sort the entities after specific criteria."                       }
         }};
         
         template<std::size_t I>
@@ -216,6 +224,8 @@ public:
         
         Bases,
         CPath,
+        Param,
+        Returns,
         Constexpr,
         
         Sort,
@@ -259,12 +269,10 @@ public:
                 throw std::invalid_argument("There is no filter option for **" + name.toStdString() + "**.");
             }
             
-            std::visit([&filter, m_val = value, m_name = name](auto &&val)
+            std::visit([&opt = it->value, m_val = value, m_name = name](auto &&val)
             {
                 using T = std::decay_t<decltype(val)>;
                 
-                auto &opt = filter.options[TypeMap::indexOf<T>].value;
-                
                 if constexpr (jaut::sameTypeIgnoreTemplate_v<venum::VenumSet, T>)
                 {
                     juce::StringArray opt_values;
@@ -0,0 +1,158 @@
+
+#include "graphcache.h"
+
+//**********************************************************************************************************************
+// region GraphCache
+//======================================================================================================================
+std::string GraphCache::makeKey(const juce::String &commit, const juce::String &qualifiedName)
+{
+    return (commit.substring(0, 12) + "-" + juce::String::toHexString(qualifiedName.hashCode64())).toStdString();
+}
+
+//======================================================================================================================
+GraphCache::GraphCache(juce::File parDirectory, std::int64_t parMaxBytes)
+    : directory(std::move(parDirectory)),
+      maxBytes(parMaxBytes)
+{}
+
+//======================================================================================================================
+void GraphCache::load()
+{
+    const std::lock_guard lock(mutex);
+    
+    (void) directory.createDirectory();
+    entries.clear();
+    numBytes = 0;
+    
+    for (const auto &file : directory.findChildFiles(juce::File::findFiles, false, "*.jpg"))
+    {
+        const std::int64_t size = file.getSize();
+        
+        (void) entries.emplace(file.getFileNameWithoutExtension().toStdString(),
+                               Entry{ file, size, file.getLastModificationTime().toMilliseconds(), {} });
+        numBytes += size;
+    }
+    
+    evict();
+}
+
+//======================================================================================================================
+GraphCache::Image GraphCache::find(const std::string &key)
+{
+    const std::lock_guard lock(mutex);
+    
+    auto it = entries.find(key);
+    
+    if (it == entries.end())
+    {
+        return nullptr;
+    }
+    
+    Entry &entry = it->second;
+    
+    if (!entry.file.existsAsFile())
+    {
+        numBytes -= entry.size;
+        entries.erase(it);
+        return nullptr;
+    }
+    
+    // The modification time is what orders images after a restart, so it is kept up to date on disk too
+    const juce::Time now = juce::Time::getCurrentTime();
+    entry.lastUsed       = now.toMilliseconds();
+    (void) entry.file.setLastModificationTime(now);
+    
+    return acquire(entry);
+}
+
+bool GraphCache::contains(const std::string &key) const
+{
+    const std::lock_guard lock(mutex);
+    return entries.find(key) != entries.end();
+}
+
+GraphCache::Image GraphCache::store(const std::string &key, const juce::MemoryBlock &image)
+{
+    const juce::File target = directory.getChildFile(juce::String(key) + ".jpg");
+    
+    const std::lock_guard lock(mutex);
+    
+    // Somebody else rendered the same graph meanwhile, theirs is kept as it might already be in use
+    if (auto it = entries.find(key); it != entries.end())
+    {
+        return acquire(it->second);
+    }
+    
+    if (!target.replaceWithData(image.getData(), image.getSize()))
+    {
+        return nullptr;
+    }
+    
+    const std::int64_t size = static_cast<std::int64_t>(image.getSize());
+    
+    Entry &entry = entries.emplace(key, Entry{ target, size, juce::Time::currentTimeMillis(), {} }).first->second;
+    numBytes    += size;
+    
+    Image cached = acquire(entry);
+    evict();
+    
+    return cached;
+}
+
+//======================================================================================================================
+std::size_t GraphCache::size() const
+{
+    const std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+std::int64_t GraphCache::getNumBytes() const
+{
+    const std::lock_guard lock(mutex);
+    return numBytes;
+}
+
+//======================================================================================================================
+GraphCache::Image GraphCache::acquire(Entry &entry)
+{
+    if (Image image = entry.inUse.lock())
+    {
+        return image;
+    }
+    
+    Image image = std::make_shared<const juce::File>(entry.file);
+    entry.inUse = image;
+    
+    return image;
+}
+
+void GraphCache::evict()
+{
+    while (numBytes > maxBytes)
+    {
+        // Images still being uploaded or held by the show cache can't go, the least recently used of the rest does
+        auto victim = entries.end();
+        
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            const Entry &entry = it->second;
+            
+            if (entry.inUse.expired() && (victim == entries.end() || entry.lastUsed < victim->second.lastUsed))
+            {
+                victim = it;
+            }
+        }
+        
+        if (victim == entries.end())
+        {
+            return;
+        }
+        
+        (void) victim->second.file.deleteFile();
+        numBytes -= victim->second.size;
+        entries.erase(victim);
+    }
+}
+//======================================================================================================================
+// endregion GraphCache
+//**********************************************************************************************************************
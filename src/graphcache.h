@@ -0,0 +1,63 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//======================================================================================================================
+/**
+ *  Keeps rendered graph images on disk across restarts, within a byte budget.
+ *  Images are named after the commit and the class they were rendered for, so an image found is always the right one
+ *  and graphs of older commits just age out.
+ *  Images handed out are never deleted while someone still holds on to them.
+ */
+class GraphCache
+{
+public:
+    using Image = std::shared_ptr<const juce::File>;
+    
+    //==================================================================================================================
+    static std::string makeKey(const juce::String &commit, const juce::String &qualifiedName);
+    
+    //==================================================================================================================
+    GraphCache(juce::File directory, std::int64_t maxBytes);
+    
+    //==================================================================================================================
+    /** Picks up the images that are on disk already, older ones are dropped first if there are too many. */
+    void load();
+    
+    //==================================================================================================================
+    Image find(const std::string &key);
+    bool  contains(const std::string &key) const;
+    
+    /** Writes a freshly rendered image into the cache, returns nothing if it couldn't be written. */
+    Image store(const std::string &key, const juce::MemoryBlock &image);
+    
+    //==================================================================================================================
+    std::size_t  size()        const;
+    std::int64_t getNumBytes() const;
+    
+private:
+    struct Entry
+    {
+        juce::File                      file;
+        std::int64_t                    size;
+        std::int64_t                    lastUsed;
+        std::weak_ptr<const juce::File> inUse;
+    };
+    
+    //==================================================================================================================
+    std::unordered_map<std::string, Entry> entries;
+    juce::File                             directory;
+    std::int64_t                           maxBytes;
+    std::int64_t                           numBytes { 0 };
+    mutable std::mutex                     mutex;
+    
+    //==================================================================================================================
+    Image acquire(Entry &entry);
+    void  evict();
+};
@@ -0,0 +1,357 @@
+
+#include "indexbuilder.h"
+
+#include "config.h"
+#include "pagedembed.h"
+#include "processsourcefiles.h"
+
+// Doxygen
+#include <classdef.h>
+#include <classlist.h>
+#include <config.h>
+#include <doxygen.h>
+#include <groupdef.h>
+#include <membername.h>
+#include <namespacedef.h>
+// STL
+#include <filesystem>
+
+#if JUCE_LINUX
+#   include <malloc.h>
+#endif
+
+//======================================================================================================================
+class ScopedWorkingDirectory
+{
+public:
+    enum WDType { System = 1, Juce = 2 };
+    
+    explicit ScopedWorkingDirectory(const juce::File &newWd, int wdType)
+        : wdType(wdType)
+    {
+        if ((wdType & WDType::System) == WDType::System)
+        {
+            oldWdSystem = std::filesystem::current_path().string();
+            std::filesystem::current_path(newWd.getFullPathName().toStdString());
+        }
+        
+        if ((wdType & WDType::Juce) == WDType::Juce)
+        {
+            oldWdJuce = juce::File::getCurrentWorkingDirectory();
+            newWd.setAsCurrentWorkingDirectory();
+        }
+    }
+    
+    ~ScopedWorkingDirectory()
+    {
+        if ((wdType & WDType::System) == WDType::System)
+        {
+            std::filesystem::current_path(oldWdSystem);
+        }
+        
+        if ((wdType & WDType::Juce) == WDType::Juce)
+        {
+            oldWdJuce.setAsCurrentWorkingDirectory();
+        }
+    }
+    
+private:
+    int wdType;
+    juce::File  oldWdJuce;
+    std::string oldWdSystem;
+};
+
+//======================================================================================================================
+namespace
+{
+    void copyList(const MemberList *src, SymbolIndex::DefVec &dest)
+    {
+        if (!src)
+        {
+            return;
+        }
+        
+        for (const auto &member : *src)
+        {
+            (void) dest.emplace_back(*member);
+        }
+    }
+    
+    void traceAndDumpClassHierarchyDfs(SymbolIndex::CacheMap &defCache, const ClassDef &classDef)
+    {
+        SymbolIndex::DefVec &list_class     = defCache[EntityType::Class];
+        SymbolIndex::DefVec &list_enum      = defCache[EntityType::Enum];
+        SymbolIndex::DefVec &list_func      = defCache[EntityType::Function];
+        SymbolIndex::DefVec &list_var       = defCache[EntityType::Field];
+        SymbolIndex::DefVec &list_alias     = defCache[EntityType::TypeAlias];
+        
+        if (!classDef.isAnonymous())
+        {
+            list_class.emplace_back(classDef);
+            
+            if (const MemberList *list = classDef.getMemberList(MemberListType_enumMembers))
+            {
+                for (const auto &en_def : *list)
+                {
+                    (void) list_enum.emplace_back(*en_def);
+                }
+            }
+            
+            copyList(classDef.getMemberList(MemberListType_functionMembers), list_func);
+            copyList(classDef.getMemberList(MemberListType_variableMembers), list_var);
+            copyList(classDef.getMemberList(MemberListType_typedefMembers),  list_alias);
+            
+            for (const auto &def : classDef.getClasses())
+            {
+                traceAndDumpClassHierarchyDfs(defCache, *def);
+            }
+        }
+    }
+}
+
+//**********************************************************************************************************************
+// region IndexBuilder
+//======================================================================================================================
+std::int64_t IndexBuilder::getMemoryStatKiB(const juce::String &name)
+{
+    juce::StringArray lines;
+    juce::File("/proc/self/status").readLines(lines);
+    
+    for (const auto &line : lines)
+    {
+        if (line.startsWith(name + ":"))
+        {
+            return line.fromFirstOccurrenceOf(":", false, false).trim().getLargeIntValue();
+        }
+    }
+    
+    return -1;
+}
+
+//======================================================================================================================
+IndexBuilder::IndexBuilder(juce::File parDirDocs, spdlog::logger &parLogger)
+    : dirDocs(std::move(parDirDocs)),
+      logger(parLogger)
+{}
+
+//======================================================================================================================
+bool IndexBuilder::build(SymbolIndex &symbolIndex, DocumentIndex &documentIndex)
+{
+    // Dangerous, but necessary.
+    // Since Doxygen uses the filesystem working directory, which is where our binary sits,
+    // we need to set this to our juce docs directory
+    anon ScopedWorkingDirectory(dirDocs, ScopedWorkingDirectory::System | ScopedWorkingDirectory::Juce);
+    
+    logger.info("Generating juce information...");
+    createFileStructure();
+    
+    logger.info("Initialising doxygen engine...");
+    initDoxygenEngine();
+    
+    logger.info("Parsing juce hierarchy...");
+    parseDoxygenFiles(symbolIndex, documentIndex);
+    
+    logger.info("Releasing doxygen...");
+    releaseDoxygen(symbolIndex);
+    
+    return compareFingerprints(symbolIndex);
+}
+
+//======================================================================================================================
+void IndexBuilder::createFileStructure()
+{
+    const juce::File build_folder("./build");
+    build_folder.deleteRecursively();
+    
+    processSourceFiles(juce::File("../../modules"), build_folder);
+}
+
+void IndexBuilder::initDoxygenEngine()
+{
+    logger.info("Configuring doxygen...");
+    initDoxygen();
+    
+    readConfiguration(0, nullptr);
+    checkConfiguration();
+    adjustConfiguration();
+    
+    Config_updateBool(GENERATE_HTML,          FALSE)
+    Config_updateBool(GENERATE_LATEX,         FALSE)
+    Config_updateBool(QUIET,                  TRUE )
+    Config_updateBool(WARNINGS,               FALSE)
+    Config_updateBool(WARN_IF_UNDOCUMENTED,   FALSE)
+    Config_updateBool(WARN_IF_DOC_ERROR,      FALSE)
+    Config_updateBool(WARN_IF_INCOMPLETE_DOC, FALSE)
+    Config_updateBool(WARN_NO_PARAMDOC,       FALSE)
+    
+    // Files are parsed on this many threads and merged back in the order they were read in, so the same entities
+    // come out however many threads were used
+    const int num_threads = AppConfig::getInstance().parseThreads;
+    logger.info("Parsing on {} threads...", num_threads);
+    Config_updateInt(NUM_PROC_THREADS, num_threads)
+    
+    if (AppConfig::getInstance().fullParse)
+    {
+        Config_updateString(DOT_IMAGE_FORMAT, "png")
+        Config_updateBool  (HAVE_DOT,         true)
+        return;
+    }
+    
+    // Nothing of this is ever read, the index only takes declarations, their docs and how classes relate.
+    // Cross references and sources are what Doxygen spends the most time and memory on besides parsing itself, the
+    // options that change what is documented or how docs read are left alone, so the same entities come out.
+    logger.info("Using the lean doxygen profile...");
+    Config_updateBool(SOURCE_BROWSER,         FALSE)
+    Config_updateBool(INLINE_SOURCES,         FALSE)
+    Config_updateBool(VERBATIM_HEADERS,       FALSE)
+    Config_updateBool(REFERENCED_BY_RELATION, FALSE)
+    Config_updateBool(REFERENCES_RELATION,    FALSE)
+    Config_updateBool(REFERENCES_LINK_SOURCE, FALSE)
+    Config_updateBool(SOURCE_TOOLTIPS,        FALSE)
+    Config_updateBool(HAVE_DOT,               FALSE)
+    Config_updateBool(CALL_GRAPH,             FALSE)
+    Config_updateBool(CALLER_GRAPH,           FALSE)
+    Config_updateBool(SEARCHENGINE,           FALSE)
+    Config_updateBool(ALPHABETICAL_INDEX,     FALSE)
+    Config_updateBool(GENERATE_TREEVIEW,      FALSE)
+    Config_updateString(GENERATE_TAGFILE,     "")
+}
+
+void IndexBuilder::parseDoxygenFiles(SymbolIndex &symbolIndex, DocumentIndex &documentIndex)
+{
+    const double start_time = juce::Time::getMillisecondCounterHiRes();
+    parseInput();
+    
+    // Printed for comparing the profiles, run once as is and once with --fullparse
+    logger.info("Parsed in {:.1f} s, peak resident memory {} MiB.",
+                (juce::Time::getMillisecondCounterHiRes() - start_time) / 1000.0, getMemoryStatKiB("VmHWM") / 1024);
+    
+    logger.info("Creating entity map...");
+    
+    // Only needed to build the indices, which copy out everything that is needed later on
+    SymbolIndex::CacheMap def_cache;
+    
+    SymbolIndex::DefVec &list_namespace = def_cache[EntityType::Namespace];
+    SymbolIndex::DefVec &list_class     = def_cache[EntityType::Class];
+    SymbolIndex::DefVec &list_enum      = def_cache[EntityType::Enum];
+    SymbolIndex::DefVec &list_func      = def_cache[EntityType::Function];
+    SymbolIndex::DefVec &list_var       = def_cache[EntityType::Field];
+    SymbolIndex::DefVec &list_alias     = def_cache[EntityType::TypeAlias];
+    
+    for (const auto &ns_def : *Doxygen::namespaceLinkedMap)
+    {
+        if (ns_def->isAnonymous() || ns_def->qualifiedName().startsWith("std"))
+        {
+            continue;
+        }
+        
+        (void) list_namespace.emplace_back(*ns_def);
+        
+        if (const MemberList *list = ns_def->getMemberList(MemberListType_enumMembers))
+        {
+            for (const auto &en_def : *list)
+            {
+                (void) list_enum.emplace_back(*en_def);
+            }
+        }
+        
+        copyList(ns_def->getMemberList(MemberListType_functionMembers), list_func);
+        copyList(ns_def->getMemberList(MemberListType_variableMembers), list_var);
+        copyList(ns_def->getMemberList(MemberListType_typedefMembers),  list_alias);
+        
+        for (const auto &cs_def : ns_def->getClasses())
+        {
+            ::traceAndDumpClassHierarchyDfs(def_cache, *cs_def);
+        }
+    }
+    
+    logger.info("Cached " + std::to_string(list_namespace.size()) + " namespaces, "
+                          + std::to_string(list_class    .size()) + " classes, "
+                          + std::to_string(list_enum     .size()) + " enums, "
+                          + std::to_string(list_func     .size()) + " functions, "
+                          + std::to_string(list_var      .size()) + " variables and "
+                          + std::to_string(list_alias    .size()) + " type aliases.");
+    
+    logger.info("Building symbol index...");
+    symbolIndex.build(def_cache);
+    logger.info("Indexed " + std::to_string(symbolIndex.size()) + " symbols under "
+                           + std::to_string(symbolIndex.getNumKeys()) + " lookup keys.");
+    logger.info("Entity fingerprint is {:016x}, detail fingerprint is {:016x}. Runs that indexed the same entities "
+                "have the same first one, the second one also needs their docs to be the same.",
+                symbolIndex.getFingerprint(), symbolIndex.getDetailFingerprint());
+    
+    logger.info("Rendering list items...");
+    PagedEmbed::prepareListItems(symbolIndex);
+    
+    logger.info("Building documentation index...");
+    documentIndex.build(symbolIndex);
+    logger.info("Indexed " + std::to_string(documentIndex.getNumTerms()) + " terms in "
+                           + std::to_string(documentIndex.getNumPostingBytes() / 1024) + " KiB of postings.");
+}
+
+bool IndexBuilder::compareFingerprints(const SymbolIndex &symbolIndex)
+{
+    const juce::String &path = AppConfig::getInstance().fingerprints;
+    
+    if (path.isEmpty())
+    {
+        return true;
+    }
+    
+    const auto to_hex = [](std::uint64_t value) { return juce::String::toHexString(static_cast<juce::int64>(value)); };
+    
+    // The first run leaves its fingerprints for the next one, which is run with the other profile
+    const juce::File   file         = juce::File(path);
+    const juce::String fingerprints = to_hex(symbolIndex.getFingerprint()) + " "
+                                      + to_hex(symbolIndex.getDetailFingerprint());
+    
+    if (!file.existsAsFile())
+    {
+        (void) file.replaceWithText(fingerprints);
+        logger.info("Wrote the fingerprints to {} for the next run to compare against.",
+                    file.getFullPathName().toStdString());
+        return true;
+    }
+    
+    const juce::String expected = file.loadFileAsString().trim();
+    
+    if (expected != fingerprints)
+    {
+        logger.error("The fingerprints {} differ from the {} in {}, the two runs didn't index the same.",
+                     fingerprints.toStdString(), expected.toStdString(), file.getFullPathName().toStdString());
+        return false;
+    }
+    
+    logger.info("The fingerprints match the ones in {}.", file.getFullPathName().toStdString());
+    return true;
+}
+
+void IndexBuilder::releaseDoxygen(SymbolIndex &symbolIndex)
+{
+    const std::int64_t rss_before = getMemoryStatKiB("VmRSS");
+    
+    // Nothing outside of the indices is pointing into Doxygen anymore, so its whole parse can go.
+    // cleanUpDoxygen() deletes the namespace, member, function and group maps, but not the class maps, which hold on
+    // to every class. Those are emptied first, while the members and namespaces the classes point into still exist.
+    symbolIndex.releaseDefinitions();
+    
+    Doxygen::classLinkedMap->clear();
+    Doxygen::hiddenClassLinkedMap->clear();
+    
+    cleanUpDoxygen();
+
+#if JUCE_LINUX
+    // Freed memory mostly stays with the allocator otherwise and never shows up as released
+    (void) malloc_trim(0);
+#endif
+
+    const std::int64_t rss_after = getMemoryStatKiB("VmRSS");
+    
+    if (rss_before >= 0 && rss_after >= 0)
+    {
+        logger.info("Resident memory went from {} MiB to {} MiB.", rss_before / 1024, rss_after / 1024);
+    }
+}
+//======================================================================================================================
+// endregion IndexBuilder
+//**********************************************************************************************************************
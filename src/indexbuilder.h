@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include "documentindex.h"
+#include "symbolindex.h"
+
+#include <juce_core/juce_core.h>
+
+#include <spdlog/spdlog.h>
+
+//======================================================================================================================
+/**
+ *  Runs Doxygen over the JUCE modules and builds the indices from what it found.
+ *  Doxygen works relative to the working directory and keeps all of its state in globals, so only one of these can
+ *  run per process and only once, Doxygen is torn down again when it's done.
+ */
+class IndexBuilder
+{
+public:
+    /** Reads one of the memory figures of this process in KiB, -1 if there is no /proc to read it from. */
+    static std::int64_t getMemoryStatKiB(const juce::String &name);
+    
+    //==================================================================================================================
+    IndexBuilder(juce::File dirDocs, spdlog::logger &logger);
+    
+    //==================================================================================================================
+    /** Returns false if the fingerprints of what was indexed don't match the ones it was told to compare against. */
+    bool build(SymbolIndex &symbolIndex, DocumentIndex &documentIndex);
+    
+private:
+    juce::File     dirDocs;
+    spdlog::logger &logger;
+    
+    //==================================================================================================================
+    void createFileStructure();
+    void initDoxygenEngine();
+    void parseDoxygenFiles(SymbolIndex &symbolIndex, DocumentIndex &documentIndex);
+    bool compareFingerprints(const SymbolIndex &symbolIndex);
+    void releaseDoxygen(SymbolIndex &symbolIndex);
+};
@@ -0,0 +1,82 @@
+
+#include "config.h"
+#include "indexbuilder.h"
+#include "indexsnapshot.h"
+
+#include <spdlog/sinks/stdout_sinks.h>
+
+namespace
+{
+    juce::String getOption(const juce::ArgumentList &args, std::string_view name)
+    {
+        return args.getValueForOption(juce::String("--") + name.data());
+    }
+}
+
+//======================================================================================================================
+// Builds the indices of one JUCE commit and writes them into a snapshot, which the bot then maps when started with
+// --indexer. Everything Doxygen allocates goes away with this process, so the bot never carries a parse around.
+int main(int argc, char *argv[])
+{
+    juce::ArgumentList argument_list(argc, argv);
+    AppConfig          &config = AppConfig::getInstance();
+    
+    // Output is passed on by the bot, which adds its own time and name to every line
+    const auto logger = spdlog::stdout_logger_mt(AppInfo::nameIndexer.data());
+    logger->set_pattern("[%l] %v");
+    
+    if (const juce::String branch = ::getOption(argument_list, "branch"); branch.isNotEmpty())
+    {
+        config.branchName = branch;
+    }
+    
+    config.currentCommit.name = ::getOption(argument_list, "commit");
+    config.currentCommit.date = ::getOption(argument_list, "date");
+    config.parseThreads       = ::getOption(argument_list, "threads").getIntValue();
+    config.fullParse          = argument_list.containsOption("--fullparse");
+    config.fingerprints       = ::getOption(argument_list, "fingerprints");
+    
+    if (config.parseThreads < 1)
+    {
+        config.parseThreads = 1;
+    }
+    
+    const juce::String output_path = ::getOption(argument_list, "output");
+    
+    if (config.currentCommit.name.isEmpty() || output_path.isEmpty())
+    {
+        logger->error("Usage: {} --commit <hash> --output <file> [--date <date>] [--branch <name>] "
+                      "[--threads <count>] [--fullparse] [--fingerprints <file>]", AppInfo::nameIndexer.data());
+        return 1;
+    }
+    
+    const juce::File dir_root = juce::File::getSpecialLocation(juce::File::currentApplicationFile).getParentDirectory();
+    const juce::File dir_docs = dir_root.getChildFile("juce/" + config.branchName + "/docs/doxygen");
+    const juce::File output   = juce::File::getCurrentWorkingDirectory().getChildFile(output_path);
+    
+    if (config.fingerprints.isNotEmpty())
+    {
+        config.fingerprints = juce::File::getCurrentWorkingDirectory().getChildFile(config.fingerprints)
+                                                                      .getFullPathName();
+    }
+    
+    SymbolIndex   symbol_index;
+    DocumentIndex document_index;
+    
+    if (!IndexBuilder(dir_docs, *logger).build(symbol_index, document_index))
+    {
+        return 1;
+    }
+    
+    logger->info("Writing index snapshot...");
+    
+    if (!IndexSnapshot::write(output, config.currentCommit, symbol_index, document_index))
+    {
+        logger->error("Couldn't write the index snapshot to {}.", output.getFullPathName().toStdString());
+        return 1;
+    }
+    
+    logger->info("Wrote {} KiB of index snapshot, peak resident memory {} MiB.", output.getSize() / 1024,
+                 IndexBuilder::getMemoryStatKiB("VmHWM") / 1024);
+    return 0;
+}
@@ -0,0 +1,92 @@
+
+#include "indexsnapshot.h"
+
+// STL
+#include <memory>
+
+//======================================================================================================================
+bool IndexSnapshot::isUpToDate(const juce::File &file, const juce::String &commit)
+{
+    juce::FileInputStream input(file);
+    return input.openedOk() && readHeader(input, commit);
+}
+
+AppConfig::Commit IndexSnapshot::getCommit(const juce::File &file)
+{
+    juce::FileInputStream input(file);
+    
+    if (!input.openedOk() || input.readInt() != magic || input.readInt() != formatVersion)
+    {
+        return {};
+    }
+    
+    AppConfig::Commit commit;
+    commit.name = input.readString();
+    commit.date = input.readString();
+    return commit;
+}
+
+//======================================================================================================================
+bool IndexSnapshot::write(const juce::File &file, const AppConfig::Commit &commit, const SymbolIndex &symbolIndex,
+                          const DocumentIndex &documentIndex)
+{
+    (void) file.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp_file(file);
+    
+    {
+        juce::FileOutputStream output(temp_file.getFile());
+        
+        if (!output.openedOk())
+        {
+            return false;
+        }
+        
+        (void) output.writeInt(magic);
+        (void) output.writeInt(formatVersion);
+        (void) output.writeString(commit.name);
+        (void) output.writeString(commit.date);
+        
+        symbolIndex.writeTo(output);
+        documentIndex.writeTo(output);
+        (void) output.writeInt(magic);
+        
+        output.flush();
+        
+        if (output.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    
+    return temp_file.overwriteTargetFileWithTemporary();
+}
+
+bool IndexSnapshot::read(const juce::File &file, const juce::String &commit, SymbolIndex &symbolIndex,
+                         DocumentIndex &documentIndex)
+{
+    // The symbol index keeps the mapping alive for as long as it points into it
+    const auto mapping = std::make_shared<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    
+    if (!mapping->getData())
+    {
+        return false;
+    }
+    
+    juce::MemoryInputStream input(mapping->getData(), mapping->getSize(), false);
+    
+    return readHeader(input, commit) && symbolIndex.readFrom(input, mapping)
+           && documentIndex.readFrom(input, symbolIndex.size()) && input.readInt() == magic;
+}
+
+//======================================================================================================================
+bool IndexSnapshot::readHeader(juce::InputStream &input, const juce::String &commit)
+{
+    if (input.readInt() != magic || input.readInt() != formatVersion || input.readString() != commit)
+    {
+        return false;
+    }
+    
+    // Only getCommit needs the date, it's skipped here
+    (void) input.readString();
+    return true;
+}
@@ -0,0 +1,42 @@
+
+#pragma once
+
+#include "config.h"
+#include "documentindex.h"
+#include "symbolindex.h"
+
+#include <juce_core/juce_core.h>
+
+//======================================================================================================================
+/**
+ *  The file the indexer hands the indices over to the bot in.
+ *  The file is mapped instead of read, the strings of the symbol index stay in there and are only paged in when they
+ *  are looked at, so the bot never holds more than the index itself.
+ *  A snapshot is only taken for the commit and version it was written for, anything else counts as no snapshot.
+ */
+class IndexSnapshot
+{
+public:
+    /** Gets whether the file holds a snapshot of the given commit, without reading any further than that. */
+    static bool isUpToDate(const juce::File &file, const juce::String &commit);
+    
+    /** Gets the commit the file holds a snapshot of, its name is empty if it holds none this version can read. */
+    static AppConfig::Commit getCommit(const juce::File &file);
+    
+    //==================================================================================================================
+    /**
+     *  Writes to a temporary file first, so that nobody ever maps a snapshot that isn't complete yet.
+     *  The date of the commit is stored along with its name, for when the snapshot is used in place of a newer one.
+     */
+    static bool write(const juce::File &file, const AppConfig::Commit &commit, const SymbolIndex &symbolIndex,
+                      const DocumentIndex &documentIndex);
+    static bool read(const juce::File &file, const juce::String &commit, SymbolIndex &symbolIndex,
+                     DocumentIndex &documentIndex);
+                     
+private:
+    static constexpr int magic         = 0x4A44534E;
+    static constexpr int formatVersion = 1;
+    
+    //==================================================================================================================
+    static bool readHeader(juce::InputStream &input, const juce::String &commit);
+};
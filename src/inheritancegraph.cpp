@@ -0,0 +1,198 @@
+
+#include "inheritancegraph.h"
+
+#include "config.h"
+
+// GraphViz
+#include <graphviz/gvc.h>
+// STL
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Graphviz' parser and layout engines are not reentrant
+    std::mutex graphMutex;
+    
+    //==================================================================================================================
+    juce::String escape(const juce::String &text)
+    {
+        return text.replace("\\", "\\\\").replace("\"", "\\\"");
+    }
+    
+    const char* getEdgeColour(Protection protection) noexcept
+    {
+        switch (protection)
+        {
+            case Protection::Protected: return "darkgreen";
+            case Protection::Private:   return "firebrick4";
+            default:                    return "midnightblue";
+        }
+    }
+    
+    GVC_t* getThreadContext()
+    {
+        // Setting up a context loads all the plugins, so every thread that renders keeps its own around
+        thread_local std::unique_ptr<GVC_t, int (*)(GVC_t*)> context(gvContext(), &gvFreeContext);
+        return context.get();
+    }
+}
+
+//**********************************************************************************************************************
+// region GraphLimits
+//======================================================================================================================
+GraphLimits GraphLimits::getDefault() noexcept
+{
+    const AppConfig &config = AppConfig::getInstance();
+    return { config.graphDepth, config.graphWidth };
+}
+//======================================================================================================================
+// endregion GraphLimits
+//**********************************************************************************************************************
+// region InheritanceGraph
+//======================================================================================================================
+juce::MemoryBlock InheritanceGraph::render(const SymbolIndex &index, SymbolIndex::EntityId id, GraphLimits limits,
+                                           QueryBudget budget)
+{
+    if (index.getBases(id).empty())
+    {
+        return {};
+    }
+    
+    const InheritanceGraph inheritance(index, id, limits);
+    const std::lock_guard  lock(graphMutex);
+    
+    // Waiting for another graph can eat up the whole budget already, layouting can't be interrupted so this is
+    // checked before every step that takes long
+    if (!budget.check())
+    {
+        return {};
+    }
+    
+    Agraph_t *const graph = agmemread(inheritance.toDot().toRawUTF8());
+    
+    if (!graph)
+    {
+        return {};
+    }
+    
+    GVC_t *const context = ::getThreadContext();
+    (void) agsafeset(graph, const_cast<char*>("bgcolor"), const_cast<char*>("white"), const_cast<char*>(""));
+    
+    juce::MemoryBlock image;
+    
+    if (gvLayout(context, graph, "dot") == 0)
+    {
+        if (budget.check())
+        {
+            char         *data  = nullptr;
+            unsigned int length = 0;
+            
+            if (gvRenderData(context, graph, "jpg", &data, &length) == 0)
+            {
+                image.append(data, length);
+            }
+            
+            gvFreeRenderData(data);
+        }
+        
+        (void) gvFreeLayout(context, graph);
+    }
+    
+    (void) agclose(graph);
+    return image;
+}
+
+//======================================================================================================================
+InheritanceGraph::InheritanceGraph(const SymbolIndex &parIndex, SymbolIndex::EntityId id, GraphLimits parLimits)
+    : index(parIndex),
+      limits(parLimits)
+{
+    dot << "digraph \"" << ::escape(index.getEntity(id).qualifiedName) << "\"\n{\n"
+        << "  edge [fontname=\"Helvetica\",fontsize=\"10\"];\n"
+        << "  node [fontname=\"Helvetica\",fontsize=\"10\",shape=box,height=0.2,width=0.4];\n";
+    
+    const int root = getNode(id).first;
+    walk(id, root, true);
+    walk(id, root, false);
+    
+    dot << "}\n";
+}
+
+//======================================================================================================================
+std::pair<int, bool> InheritanceGraph::getNode(SymbolIndex::EntityId id)
+{
+    const auto [it, is_new] = nodes.emplace(id, numNodes);
+    
+    if (is_new)
+    {
+        dot << "  Node" << numNodes << " [label=\"" << ::escape(index.getEntity(id).qualifiedName) << "\""
+            << (numNodes == 0 ? ",style=filled,fillcolor=\"grey75\"" : "") << "];\n";
+        ++numNodes;
+    }
+    
+    return { it->second, is_new };
+}
+
+std::pair<int, bool> InheritanceGraph::getExternalNode(const juce::String &name)
+{
+    const auto [it, is_new] = externalNodes.emplace(name, numNodes);
+    
+    // Drawn like Doxygen draws classes it has no docs for
+    if (is_new)
+    {
+        dot << "  Node" << numNodes << " [label=\"" << ::escape(name) << "\",color=\"grey75\"];\n";
+        ++numNodes;
+    }
+    
+    return { it->second, is_new };
+}
+
+void InheritanceGraph::walk(SymbolIndex::EntityId start, int startNode, bool upwards)
+{
+    // Breadth first, so that it's the far away relatives that get collapsed and not the close ones
+    std::vector<Pending> queue { Pending{ start, startNode, 0 } };
+    
+    for (std::size_t i = 0; i < queue.size(); ++i)
+    {
+        const Pending                   current   = queue[i];
+        const SymbolIndex::RelativeList &relatives = (upwards ? index.getBases(current.id)
+                                                              : index.getDerived(current.id));
+        const int                       num_shown = (current.level < limits.depth
+                                                         ? std::min(limits.width, static_cast<int>(relatives.size()))
+                                                         : 0);
+        
+        for (int j = 0; j < num_shown; ++j)
+        {
+            const SymbolIndex::Relative &relative = relatives[static_cast<std::size_t>(j)];
+            const auto [node, is_new]             = (relative.isIndexed() ? getNode(relative.id)
+                                                                          : getExternalNode(index.getName(relative)));
+            
+            // Edges always go from base to derived and point back, that's how Doxygen draws them too
+            dot << "  Node" << (upwards ? node : current.node) << " -> Node" << (upwards ? current.node : node)
+                << " [dir=\"back\",color=\"" << ::getEdgeColour(relative.protection) << "\",style=\""
+                << (relative.isVirtual ? "dashed" : "solid") << "\"];\n";
+            
+            // Nothing is known about what lies beyond a class that isn't indexed
+            if (is_new && relative.isIndexed())
+            {
+                queue.push_back(Pending{ relative.id, node, current.level + 1 });
+            }
+        }
+        
+        if (const int num_left = static_cast<int>(relatives.size()) - num_shown; num_left > 0)
+        {
+            const int summary = numNodes++;
+            
+            dot << "  Node" << summary << " [label=\"" << num_left << " more...\","
+                << "color=\"grey50\",fontcolor=\"grey50\",style=\"dashed\"];\n"
+                << "  Node" << (upwards ? summary : current.node) << " -> Node"
+                << (upwards ? current.node : summary) << " [dir=\"back\",color=\"grey50\",style=\"dashed\"];\n";
+        }
+    }
+}
+//======================================================================================================================
+// endregion InheritanceGraph
+//**********************************************************************************************************************
@@ -0,0 +1,74 @@
+
+#pragma once
+
+#include "querybudget.h"
+#include "symbolindex.h"
+
+#include <juce_core/juce_core.h>
+
+#include <unordered_map>
+
+//======================================================================================================================
+/** How many levels of bases and derived classes a graph shows, and how many classes per level and parent. */
+struct GraphLimits
+{
+    int depth;
+    int width;
+    
+    // Draws the bases as text instead, which is immediate
+    bool textOnly { false };
+    
+    //==================================================================================================================
+    static GraphLimits getDefault() noexcept;
+    
+    //==================================================================================================================
+    bool operator==(const GraphLimits &rhs) const noexcept
+    {
+        return depth == rhs.depth && width == rhs.width && textOnly == rhs.textOnly;
+    }
+    
+    bool operator!=(const GraphLimits &rhs) const noexcept { return !(*this == rhs); }
+};
+
+//======================================================================================================================
+/**
+ *  Writes the DOT text of the inheritance graph of a class, up through its bases and down through what derives from
+ *  it.
+ *  Only so many levels and so many classes next to each other are drawn, whatever is left over is collapsed into a
+ *  summary node, so that classes with huge hierarchies still lay out in about the same time as any other.
+ *  Everything is taken from the index, so this works just as well when Doxygen was never run.
+ */
+class InheritanceGraph
+{
+public:
+    /** Renders the inheritance graph of a class as JPEG, empty if it has no bases or if the budget runs out. */
+    static juce::MemoryBlock render(const SymbolIndex &index, SymbolIndex::EntityId id, GraphLimits limits,
+                                    QueryBudget budget = {});
+    
+    //==================================================================================================================
+    InheritanceGraph(const SymbolIndex &index, SymbolIndex::EntityId id, GraphLimits limits);
+    
+    //==================================================================================================================
+    const juce::String& toDot() const noexcept { return dot; }
+    
+private:
+    struct Pending
+    {
+        SymbolIndex::EntityId id;
+        int                   node;
+        int                   level;
+    };
+    
+    //==================================================================================================================
+    const SymbolIndex                              &index;
+    GraphLimits                                    limits;
+    std::unordered_map<SymbolIndex::EntityId, int> nodes;
+    std::unordered_map<juce::String, int>          externalNodes;
+    juce::String                                   dot;
+    int                                            numNodes { 0 };
+    
+    //==================================================================================================================
+    std::pair<int, bool> getNode(SymbolIndex::EntityId id);
+    std::pair<int, bool> getExternalNode(const juce::String &name);
+    void                 walk(SymbolIndex::EntityId start, int startNode, bool upwards);
+};
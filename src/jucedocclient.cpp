@@ -2,27 +2,11 @@
 #include "jucedocclient.h"
 
 #include "commands.h"
-#include "entitydefinition.h"
-#include "filter.h"
-#include "linkresolve.h"
-#include "processsourcefiles.h"
-
-// Doxygen
-#include <classdef.h>
-#include <classlist.h>
-#include <config.h>
-#include <dir.h>
-#include <doxygen.h>
-#include <filedef.h>
-#include <filename.h>
-#include <groupdef.h>
-#include <membername.h>
-#include <outputgen.h>
-#include <parserintf.h>
-#include <util.h>
+#include "indexbuilder.h"
+#include "indexsnapshot.h"
+
 // STL
-#include <filesystem>
-#include <regex>
+#include <limits>
 
 #if JUCE_DEBUG
 #   define JD_DBG(MSG) logger->debug(MSG)
@@ -30,95 +14,6 @@
 #   define JD_DBG(MSG) (void) 0
 #endif
 
-//======================================================================================================================
-class ScopedWorkingDirectory
-{
-public:
-    enum WDType { System = 1, Juce = 2 };
-    
-    explicit ScopedWorkingDirectory(const juce::File &newWd, int wdType)
-        : wdType(wdType)
-    {
-        if ((wdType & WDType::System) == WDType::System)
-        {
-            oldWdSystem = std::filesystem::current_path().string();
-            std::filesystem::current_path(newWd.getFullPathName().toStdString());
-        }
-        
-        if ((wdType & WDType::Juce) == WDType::Juce)
-        {
-            oldWdJuce = juce::File::getCurrentWorkingDirectory();
-            newWd.setAsCurrentWorkingDirectory();
-        }
-    }
-    
-    ~ScopedWorkingDirectory()
-    {
-        if ((wdType & WDType::System) == WDType::System)
-        {
-            std::filesystem::current_path(oldWdSystem);
-        }
-        
-        if ((wdType & WDType::Juce) == WDType::Juce)
-        {
-            oldWdJuce.setAsCurrentWorkingDirectory();
-        }
-    }
-
-private:
-    int wdType;
-    juce::File  oldWdJuce;
-    std::string oldWdSystem;
-};
-
-//======================================================================================================================
-namespace
-{
-    void copyList(const MemberList *src, JuceDocClient::DefVec &dest)
-    {
-        if (!src)
-        {
-            return;
-        }
-        
-        for (const auto &member : *src)
-        {
-            (void) dest.emplace_back(*member);
-        }
-    }
-    
-    void traceAndDumpClassHierarchyDfs(JuceDocClient::CacheMap &defCache, const ClassDef &classDef)
-    {
-        JuceDocClient::DefVec &list_class     = defCache[EntityType::Class];
-        JuceDocClient::DefVec &list_enum      = defCache[EntityType::Enum];
-        JuceDocClient::DefVec &list_func      = defCache[EntityType::Function];
-        JuceDocClient::DefVec &list_var       = defCache[EntityType::Field];
-        JuceDocClient::DefVec &list_alias     = defCache[EntityType::TypeAlias];
-        
-        if (!classDef.isAnonymous())
-        {
-            list_class.emplace_back(classDef);
-            
-            if (const MemberList *list = classDef.getMemberList(MemberListType_enumMembers))
-            {
-                for (const auto &en_def : *list)
-                {
-                    (void) list_enum.emplace_back(*en_def);
-                }
-            }
-    
-            copyList(classDef.getMemberList(MemberListType_functionMembers), list_func);
-            copyList(classDef.getMemberList(MemberListType_variableMembers), list_var);
-            copyList(classDef.getMemberList(MemberListType_typedefMembers),  list_alias);
-            
-            for (const auto &def : classDef.getClasses())
-            {
-                traceAndDumpClassHierarchyDfs(defCache, *def);
-            }
-        }
-    }
-}
-
 //**********************************************************************************************************************
 // region JuceDocClient
 //======================================================================================================================
@@ -134,6 +29,8 @@ JuceDocClient::EmbedCacheBuffer::EmbedCacheBuffer(int cacheSize)
 //======================================================================================================================
 void JuceDocClient::EmbedCacheBuffer::pop()
 {
+    const juce::ScopedLock scoped_lock(*lock);
+    
     if (!isEmpty())
     {
         buffer[tail].second.reset();
@@ -143,6 +40,8 @@ void JuceDocClient::EmbedCacheBuffer::pop()
 
 void JuceDocClient::EmbedCacheBuffer::push(PagedEmbed &&embed)
 {
+    const juce::ScopedLock scoped_lock(*lock);
+    
     if (isFull())
     {
         pop();
@@ -198,6 +97,12 @@ JuceDocClient::JuceDocClient(const juce::String &parToken, juce::String parClien
 #endif
 }
 
+JuceDocClient::~JuceDocClient()
+{
+    // Whatever was counted since the last save would be lost otherwise
+    queryLog.save();
+}
+
 //======================================================================================================================
 void JuceDocClient::onMessage(SleepyDiscord::Message message)
 {
@@ -214,6 +119,11 @@ void JuceDocClient::onMessage(SleepyDiscord::Message message)
             return;
         }
         
+        if (!admitRequest(message))
+        {
+            return;
+        }
+        
         const juce::String args_string = content.fromFirstOccurrenceOf((mobmen ? "<@" : "<@!") + clientId + ">", false, false).trim();
         juce::StringArray  args        = juce::StringArray::fromTokens(args_string, true);
         
@@ -270,20 +180,24 @@ void JuceDocClient::onReady(sld::Ready readyData)
         JD_DBG("Registered server for id: " + guild.ID.string());
     }
     
+    logger->info("Clearing temporary files...");
+    createFileStructure();
+    
+    // Doxygen only runs in here when there's no indexer to run it, a parse that breaks the indexer would break the bot
+    const IndexLoad index_load = (AppConfig::getInstance().useIndexer ? loadIndexFromIndexer() : IndexLoad::NotStarted);
+    
+    if (index_load == IndexLoad::Failed)
     {
-        // Dangerous, but necessary.
-        // Since Doxygen uses the filesystem working directory, which is where our binary sits,
-        // we need to set this to our juce docs directory
-        anon ScopedWorkingDirectory(dirDocs, ScopedWorkingDirectory::System | ScopedWorkingDirectory::Juce);
-        
-        logger->info("Generating juce information...");
-        createFileStructure();
-        
-        logger->info("Initialising doxygen engine...");
-        initDoxygenEngine();
-        
-        logger->info("Parsing juce hierarchy...");
-        parseDoxygenFiles();
+        logger->critical("There is no index to answer queries with, shutting down.");
+        quit();
+        return;
+    }
+    
+    if (index_load == IndexLoad::NotStarted && !IndexBuilder(dirDocs, *logger).build(symbolIndex, documentIndex))
+    {
+        logger->critical("The index doesn't match the one compared against, shutting down.");
+        quit();
+        return;
     }
     
     logger->info("Preparing command provider...");
@@ -292,6 +206,16 @@ void JuceDocClient::onReady(sld::Ready readyData)
     commands.emplace_back(std::make_unique<CommandShow>   (*this));
     commands.emplace_back(std::make_unique<CommandAbout>  (*this));
     commands.emplace_back(std::make_unique<CommandFilters>(*this));
+    commands.emplace_back(std::make_unique<CommandSuggest>(*this));
+    commands.emplace_back(std::make_unique<CommandSearch> (*this));
+    
+    graphCache.load();
+    logger->info("Found " + std::to_string(graphCache.size()) + " rendered graphs ("
+                 + std::to_string(graphCache.getNumBytes() / 1024) + " KiB).");
+    
+    logger->info("Warming up caches...");
+    warmUpCaches();
+    preRenderGraphs();
     
     logger->info("JuceDoc is now ready to be used.");
     busy.store(false);
@@ -320,18 +244,98 @@ void JuceDocClient::onReaction(sld::Snowflake<sld::User> userId, sld::Snowflake<
         
     applyData<EmbedCacheBuffer>(getChannel(channelId).cast().serverID, [this, &message, &emote, &userId](auto &&cache)
     {
-        if (PagedEmbed *const embed = cache.get(message.ID))
+        const sld::Embed pre_embed = message.embeds[0];
+        PagedEmbed       embed;
+        
+        // Only copied under the lock, the cache must never wait on a query that's still running
+        if (!cache.withEmbed(message.ID, [&embed](PagedEmbed &cached) { embed = cached; }))
         {
-            removeReaction(message.channelID, message.ID, emote.name, userId);
-            embed->setPage(emote.name == PagedEmbed::emoteLastPage ? PagedEmbed::PageAction::Back
-                                                                   : PagedEmbed::PageAction::Forward);
-            
-            const sld::Embed pre_embed = message.embeds[0];
-            editMessage(message, "", embed->toEmbed(pre_embed.title, pre_embed.color));
+            return;
+        }
+        
+        removeReaction(message.channelID, message.ID, emote.name, userId);
+        
+        if (!embed.setPage(emote.name == PagedEmbed::emoteLastPage ? PagedEmbed::PageAction::Back
+                                                                   : PagedEmbed::PageAction::Forward))
+        {
+            sendMessage(message.channelID, "The next page is still loading, try again in a moment.");
+            return;
         }
+        
+        (void) cache.withEmbed(message.ID, [&embed](PagedEmbed &cached) { cached = embed; });
+        editMessage(message, "", embed.toEmbed(pre_embed.title, pre_embed.color));
     });
 }
 
+//======================================================================================================================
+void JuceDocClient::sendEmbeds(const sld::Snowflake<sld::Channel> &channelId, const std::string &content,
+                               const std::vector<sld::Embed> &embeds, const std::vector<juce::File> &files,
+                               std::function<void(sld::Response)> callback)
+{
+    std::vector<std::string> serialised;
+    serialised.reserve(embeds.size());
+    
+    for (const auto &embed : embeds)
+    {
+        serialised.emplace_back(sld::json::stringifyObj(embed));
+    }
+    
+    sendSerialisedEmbeds(channelId, content, serialised, files, std::move(callback));
+}
+
+void JuceDocClient::sendSerialisedEmbeds(const sld::Snowflake<sld::Channel> &channelId, const std::string &content,
+                                         const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                                         std::function<void(sld::Response)> callback)
+{
+    sendPayload(sld::Post, path("channels/{channel.id}/messages", { channelId.string() }), content, embeds, files,
+                std::move(callback));
+}
+
+void JuceDocClient::editSerialisedEmbeds(const sld::Snowflake<sld::Channel> &channelId,
+                                         const sld::Snowflake<sld::Message> &messageId, const std::string &content,
+                                         const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                                         std::function<void(sld::Response)> callback)
+{
+    // Files sent along with an edit are added to the attachments the message already has
+    sendPayload(sld::Patch,
+                path("channels/{channel.id}/messages/{message.id}", { channelId.string(), messageId.string() }),
+                content, embeds, files, std::move(callback));
+}
+
+void JuceDocClient::sendPayload(sld::RequestMethod method, const sld::Route &route, const std::string &content,
+                                const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                                std::function<void(sld::Response)> callback)
+{
+    // sleepy-discord only knows single embed, single file messages, so the payload is put together by hand
+    juce::String payload;
+    payload << "{\"content\":" << juce::JSON::toString(juce::var(juce::String(content))) << ",\"embeds\":[";
+    
+    for (std::size_t i = 0; i < embeds.size(); ++i)
+    {
+        payload << (i > 0 ? "," : "") << juce::String(embeds[i]);
+    }
+    
+    payload << "]}";
+    
+    if (files.empty())
+    {
+        (void) request(method, route, payload.toStdString(), {}, std::move(callback));
+        return;
+    }
+    
+    std::vector<sld::Part> parts;
+    parts.reserve(files.size() + 1);
+    
+    for (std::size_t i = 0; i < files.size(); ++i)
+    {
+        parts.emplace_back("files[" + std::to_string(i) + "]",
+                           sld::filePathPart{ files[i].getFullPathName().toStdString() });
+    }
+    
+    parts.emplace_back("payload_json", payload.toStdString());
+    (void) request(method, route, "", parts, std::move(callback));
+}
+
 //======================================================================================================================
 juce::String JuceDocClient::getActivator() const { return "<@!" + clientId + ">"; }
 
@@ -342,6 +346,40 @@ void JuceDocClient::notifyBusy(const sld::Message &msg)
                                "Please come back at a later time and try again.");
 }
 
+bool JuceDocClient::admitRequest(const sld::Message &msg)
+{
+    // The user is asked first, so that one person spamming runs dry before eating up the share of the whole guild.
+    // Direct messages have no guild, they would all end up sharing one bucket, so only the user limit applies there.
+    const std::string    user_key  = msg.author.ID.string();
+    const std::string    guild_key = msg.serverID.string();
+    RateLimiter::Verdict verdict   = userLimiter.acquire(user_key);
+    
+    if (verdict == RateLimiter::Verdict::Admitted && !guild_key.empty())
+    {
+        verdict = guildLimiter.acquire(guild_key);
+        
+        // A busy guild is no reason for the user to lose their own share
+        if (verdict != RateLimiter::Verdict::Admitted)
+        {
+            userLimiter.refund(user_key);
+        }
+    }
+    
+    if (verdict == RateLimiter::Verdict::Refused)
+    {
+        const RateLimiter::Counters user_counters  = userLimiter .getCounters();
+        const RateLimiter::Counters guild_counters = guildLimiter.getCounters();
+        logger->info("Rate limited user '{}' in server '{}', refused so far: {} by user and {} by server limits",
+                     msg.author.ID.string(), msg.serverID.string(), user_counters.refused, guild_counters.refused);
+        
+        // Only the first refused request gets an answer, everything after it is dropped until things calm down
+        sendMessage(msg.channelID, "Woah, slow down a little, I can't keep up with that many requests. :hourglass:\n"
+                                   "Give me a few seconds and try again.");
+    }
+    
+    return verdict == RateLimiter::Verdict::Admitted;
+}
+
 //======================================================================================================================
 void JuceDocClient::showHelpPage(sld::Message &message, const juce::String &cmd)
 {
@@ -392,86 +430,252 @@ void JuceDocClient::showHelpPage(sld::Message &message, const juce::String &cmd)
 }
 
 //======================================================================================================================
-void JuceDocClient::initDoxygenEngine()
+void JuceDocClient::warmUpCaches()
 {
-    logger->info("Configurung doxygen...");
-    initDoxygen();
-    
-    readConfiguration(0, nullptr);
-    checkConfiguration();
-    adjustConfiguration();
-    
-    Config_updateBool(GENERATE_HTML,          FALSE)
-    Config_updateBool(GENERATE_LATEX,         FALSE)
-    Config_updateBool(QUIET,                  TRUE )
-    Config_updateBool(WARNINGS,               FALSE)
-    Config_updateBool(WARN_IF_UNDOCUMENTED,   FALSE)
-    Config_updateBool(WARN_IF_DOC_ERROR,      FALSE)
-    Config_updateBool(WARN_IF_INCOMPLETE_DOC, FALSE)
-    Config_updateBool(WARN_NO_PARAMDOC,       FALSE)
-    
-    Config_updateString(DOT_IMAGE_FORMAT,     "png")
-    Config_updateBool  (HAVE_DOT,             true)
+    const AppConfig &config = AppConfig::getInstance();
+    
+    // Loaded either way, what is counted from here on is added to the counts from before and saved with them
+    queryLog.load();
+    
+    if (config.warmUpCount < 1)
+    {
+        return;
+    }
+    
+    juce::StringArray names = queryLog.getMostFrequent(config.warmUpCount);
+    
+    if (names.isEmpty())
+    {
+        for (const auto &name : AppInfo::coreClasses)
+        {
+            names.add(name.data());
+        }
+    }
+    
+    std::vector<const SymbolIndex::Entity*> entities;
+    
+    for (const auto &name : names)
+    {
+        if (const SymbolIndex::Lookup lookup = symbolIndex.resolve(name); lookup.match)
+        {
+            entities.emplace_back(lookup.match);
+        }
+    }
+    
+    if (entities.empty())
+    {
+        return;
+    }
+    
+    // Jobs that didn't make it in time see the exhausted budget and skip, so they can safely outlive this call
+    struct WarmUpState
+    {
+        juce::WaitableEvent finished;
+        std::atomic<int>    remaining;
+    };
+    
+    const QueryBudget budget(config.warmUpTimeMs, std::numeric_limits<std::int64_t>::max());
+    const double      start_time = juce::Time::getMillisecondCounterHiRes();
+    
+    auto state       = std::make_shared<WarmUpState>();
+    state->remaining = static_cast<int>(entities.size());
+    
+    for (const auto *entity : entities)
+    {
+        workerPool.addJob([this, state, entity, budget]()
+        {
+            const auto done = [state](auto&&)
+            {
+                if (state->remaining.fetch_sub(1) == 1)
+                {
+                    state->finished.signal();
+                }
+            };
+            
+            if (QueryBudget job_budget = budget; job_budget.check())
+            {
+                CommandShow::completeResult(*this, *entity, CommandShow::fetchResult(*this, *entity), job_budget, done);
+            }
+            else
+            {
+                done(nullptr);
+            }
+        });
+    }
+    
+    (void) state->finished.wait(config.warmUpTimeMs);
+    
+    const double elapsed_ms = juce::Time::getMillisecondCounterHiRes() - start_time;
+    logger->info("Warmed up " + std::to_string(showCache.size()) + " of " + std::to_string(entities.size())
+                 + " entities (" + std::to_string(showCache.getNumBytes() / 1024) + " KiB) in "
+                 + juce::String(elapsed_ms, 0).toStdString() + " ms.");
 }
 
-void JuceDocClient::parseDoxygenFiles()
+void JuceDocClient::preRenderGraphs()
 {
-    parseInput();
-    logger->info("Creating entity map...");
+    const AppConfig &config = AppConfig::getInstance();
+    
+    if (!config.preRender)
+    {
+        return;
+    }
+    
+    auto pre_render = std::make_shared<PreRender>();
     
-    for (auto &ns_def : *Doxygen::namespaceLinkedMap)
+    for (const auto &id : symbolIndex.getEntities(EntityType::Class))
     {
-        if (!ns_def->isAnonymous() && !ns_def->qualifiedName().startsWith("std"))
+        const SymbolIndex::Entity &entity = symbolIndex.getEntity(id);
+        
+        if (!symbolIndex.getBases(id).empty() && !graphCache.contains(CommandShow::getGraphKey(entity)))
         {
-            (void) namespaces.emplace_back(ns_def.release()).get();
+            pre_render->classes.emplace_back(&entity);
         }
     }
     
-    DefVec &list_namespace = defCache[EntityType::Namespace];
-    DefVec &list_class     = defCache[EntityType::Class];
-    DefVec &list_enum      = defCache[EntityType::Enum];
-    DefVec &list_func      = defCache[EntityType::Function];
-    DefVec &list_var       = defCache[EntityType::Field];
-    DefVec &list_alias     = defCache[EntityType::TypeAlias];
-    
-    for (const auto &ns_def : namespaces)
+    if (!pre_render->classes.empty())
+    {
+        logger->info("Rendering " + std::to_string(pre_render->classes.size()) + " graphs in the background...");
+        preRenderNext(std::move(pre_render), 0);
+    }
+}
+
+void JuceDocClient::preRenderNext(std::shared_ptr<PreRender> preRender, std::size_t next)
+{
+    // Only one pre-render is queued at a time, so a graph someone is waiting for never waits for more than that
+    if (next < preRender->classes.size())
     {
-        (void) list_namespace.emplace_back(*ns_def);
+        const SymbolIndex::Entity &entity = *preRender->classes[next];
         
-        if (const MemberList *list = ns_def->getMemberList(MemberListType_enumMembers))
+        const auto continue_with_next = [this, preRender, next](const RenderPool::Image &image)
         {
-            for (const auto &en_def : *list)
+            if (image)
             {
-                (void) list_enum.emplace_back(*en_def);
+                ++preRender->numRendered;
             }
-        }
-    
-        copyList(ns_def->getMemberList(MemberListType_functionMembers), list_func);
-        copyList(ns_def->getMemberList(MemberListType_variableMembers), list_var);
-        copyList(ns_def->getMemberList(MemberListType_typedefMembers),  list_alias);
+            
+            preRenderNext(preRender, next + 1);
+        };
         
-        for (const auto &cs_def : ns_def->getClasses())
+        // Requests filled up the queue, the same class is tried again as soon as one of them is done
+        if (!CommandShow::submitGraph(*this, entity, {}, continue_with_next))
         {
-            ::traceAndDumpClassHierarchyDfs(defCache, *cs_def);
+            renderPool.whenAvailable([this, preRender, next]() { preRenderNext(preRender, next); });
         }
+        
+        return;
     }
     
-    logger->info("Cached " + std::to_string(list_namespace.size()) + " namespaces, "
-                           + std::to_string(list_class    .size()) + " classes, "
-                           + std::to_string(list_enum     .size()) + " enums, "
-                           + std::to_string(list_func     .size()) + " functions, "
-                           + std::to_string(list_var      .size()) + " variables and "
-                           + std::to_string(list_alias    .size()) + " type aliases.");
+    logger->info("Pre-rendered " + std::to_string(preRender->numRendered.load()) + " of "
+                 + std::to_string(preRender->classes.size()) + " graphs, " + std::to_string(graphCache.size())
+                 + " are cached (" + std::to_string(graphCache.getNumBytes() / 1024) + " KiB).");
 }
 
 void JuceDocClient::createFileStructure()
 {
+    // Dot files are only valid for the commit they were written for
+    (void) dirTemp.deleteRecursively();
     (void) dirTemp.createDirectory();
+}
+
+JuceDocClient::IndexLoad JuceDocClient::loadIndexFromIndexer()
+{
+    AppConfig          &config  = AppConfig::getInstance();
+    const juce::String commit   = config.currentCommit.name;
+    const juce::File   snapshot = dirRoot.getChildFile("index/" + config.branchName + ".snapshot");
     
-    const juce::File build_folder("./build");
-    build_folder.deleteRecursively();
+    // A comparison needs a parse, the snapshot it would be reused from could have come from the other profile
+    if (config.fingerprints.isEmpty() && IndexSnapshot::isUpToDate(snapshot, commit))
+    {
+        logger->info("Found an index snapshot of this commit, not running the indexer...");
+    }
+    else
+    {
+        juce::StringArray args {
+            dirRoot.getChildFile(AppInfo::nameIndexer.data()).getFullPathName(),
+            "--branch",  config.branchName,
+            "--commit",  commit,
+            "--date",    config.currentCommit.date,
+            "--output",  snapshot.getFullPathName(),
+            "--threads", juce::String(config.parseThreads)
+        };
+        
+        if (config.fullParse)
+        {
+            args.add("--fullparse");
+        }
+        
+        if (config.fingerprints.isNotEmpty())
+        {
+            args.addArray({ "--fingerprints", config.fingerprints });
+        }
+        
+        logger->info("Running the indexer...");
+        juce::ChildProcess indexer;
+        
+        if (!indexer.start(args))
+        {
+            logger->error("Couldn't start the indexer, indexing in this process instead...");
+            return IndexLoad::NotStarted;
+        }
+        
+        // Passed on line by line while it's running, a parse takes a while and shouldn't look like a hang
+        std::string output;
+        char        buffer[4096];
+        
+        for (int num_read; (num_read = indexer.readProcessOutput(buffer, sizeof(buffer))) > 0;)
+        {
+            output.append(buffer, static_cast<std::size_t>(num_read));
+            
+            for (std::size_t end; (end = output.find('\n')) != std::string::npos; output.erase(0, end + 1))
+            {
+                logger->info("Indexer: {}", std::string_view(output).substr(0, end));
+            }
+        }
+        
+        if (!output.empty())
+        {
+            logger->info("Indexer: {}", output);
+        }
+        
+        if (!indexer.waitForProcessToFinish(-1) || indexer.getExitCode() != 0)
+        {
+            logger->error("The indexer failed with exit code {}.", indexer.getExitCode());
+            
+            // Falling back to an older snapshot would hide that the fingerprints didn't match
+            if (config.fingerprints.isNotEmpty())
+            {
+                return IndexLoad::Failed;
+            }
+            
+            // A failed run never replaces the snapshot, so the one of an earlier commit is still there to be used
+            const AppConfig::Commit kept_commit = IndexSnapshot::getCommit(snapshot);
+            
+            if (kept_commit.name.isEmpty())
+            {
+                logger->error("There is no earlier index snapshot to keep.");
+                return IndexLoad::Failed;
+            }
+            
+            logger->warn("Keeping the index snapshot of commit {}, answers may be out of date.",
+                         kept_commit.name.toStdString());
+            
+            // Everything from footers to cache keys is about the commit the answers come from, not the one checked out
+            config.currentCommit = kept_commit;
+        }
+    }
+    
+    if (!IndexSnapshot::read(snapshot, config.currentCommit.name, symbolIndex, documentIndex))
+    {
+        logger->error("Couldn't read the index snapshot.");
+        return IndexLoad::Failed;
+    }
     
-    processSourceFiles(juce::File("../../modules"), build_folder);
+    logger->info("Mapped " + std::to_string(symbolIndex.size()) + " symbols and "
+                           + std::to_string(documentIndex.getNumTerms()) + " terms from the index snapshot.");
+    logger->info("Entity fingerprint is {:016x}, detail fingerprint is {:016x}, resident memory is {} MiB.",
+                 symbolIndex.getFingerprint(), symbolIndex.getDetailFingerprint(),
+                 IndexBuilder::getMemoryStatKiB("VmRSS") / 1024);
+    return IndexLoad::Loaded;
 }
 
 //======================================================================================================================
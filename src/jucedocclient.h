@@ -1,14 +1,20 @@
 
 #pragma once
 
+#include "attachmentcache.h"
 #include "config.h"
 #include "commandbase.h"
 #include "specs.h"
 
 #include "pagedembed.h"
+#include "documentindex.h"
+#include "graphcache.h"
 #include "guildstorage.h"
-
-#include <namespacedef.h>
+#include "querylog.h"
+#include "ratelimiter.h"
+#include "renderpool.h"
+#include "showcache.h"
+#include "symbolindex.h"
 
 #include <sleepy_discord/websocketpp_websocket.h>
 #include <juce_core/juce_core.h>
@@ -41,6 +47,20 @@ public:
         PagedEmbed       *get(const sld::Snowflake<sld::Message>&);
         const PagedEmbed *get(const sld::Snowflake<sld::Message>&) const;
         
+        template<class Fn>
+        bool withEmbed(const sld::Snowflake<sld::Message> &messageId, Fn &&func)
+        {
+            const juce::ScopedLock scoped_lock(*lock);
+            
+            if (PagedEmbed *const embed = get(messageId))
+            {
+                std::forward<Fn>(func)(*embed);
+                return true;
+            }
+            
+            return false;
+        }
+        
         //==============================================================================================================
         bool isFull()  const noexcept;
         bool isEmpty() const noexcept;
@@ -53,6 +73,9 @@ public:
         std::vector<std::pair<sld::Snowflake<sld::Message>, PagedEmbed>> buffer;
         std::size_t head {};
         std::size_t tail {};
+        
+        // Paged embeds are filled from worker threads while reactions come in
+        std::unique_ptr<juce::CriticalSection> lock { std::make_unique<juce::CriticalSection>() };
     };
     
     //==================================================================================================================
@@ -62,6 +85,7 @@ public:
     
     //==================================================================================================================
     JuceDocClient(const juce::String &token, juce::String clientId);
+    ~JuceDocClient() override;
     
     //==================================================================================================================
     void onMessage (sld::Message) override;
@@ -72,7 +96,23 @@ public:
                     sld::Emoji) override;
     
     //==================================================================================================================
-    const CacheMap& getCache() const noexcept { return defCache; }
+    const SymbolIndex&   getIndex()         const noexcept { return symbolIndex;   }
+    const DocumentIndex& getDocumentIndex() const noexcept { return documentIndex; }
+    
+    //==================================================================================================================
+    juce::ThreadPool& getWorkerPool() noexcept { return workerPool; }
+    RenderPool&       getRenderPool() noexcept { return renderPool; }
+    
+    //==================================================================================================================
+    const RateLimiter& getGuildLimiter() const noexcept { return guildLimiter; }
+    const RateLimiter& getUserLimiter()  const noexcept { return userLimiter;  }
+    
+    //==================================================================================================================
+    ShowCache&  getShowCache()  noexcept { return showCache;  }
+    QueryLog&   getQueryLog()   noexcept { return queryLog;   }
+    GraphCache& getGraphCache() noexcept { return graphCache; }
+    
+    AttachmentCache& getAttachmentCache() noexcept { return attachmentCache; }
     
     //==================================================================================================================
     const juce::File &getDirRoot() const noexcept { return dirRoot; }
@@ -83,6 +123,22 @@ public:
     //==================================================================================================================
     spdlog::logger& getLogger() noexcept { return *logger; }
     
+    //==================================================================================================================
+    void sendEmbeds(const sld::Snowflake<sld::Channel> &channelId, const std::string &content,
+                    const std::vector<sld::Embed> &embeds, const std::vector<juce::File> &files,
+                    std::function<void(sld::Response)> callback = nullptr);
+    
+    /** Same as sendEmbeds, but takes embeds that have already been turned into JSON. */
+    void sendSerialisedEmbeds(const sld::Snowflake<sld::Channel> &channelId, const std::string &content,
+                              const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                              std::function<void(sld::Response)> callback = nullptr);
+    
+    /** Replaces the embeds of a message that was sent before, and attaches the given files to it. */
+    void editSerialisedEmbeds(const sld::Snowflake<sld::Channel> &channelId,
+                              const sld::Snowflake<sld::Message> &messageId, const std::string &content,
+                              const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                              std::function<void(sld::Response)> callback = nullptr);
+    
     //==================================================================================================================
     template<class T, class Fn>
     bool applyData(const sld::Snowflake<sld::Server> &id, Fn &&func)
@@ -103,9 +159,23 @@ public:
     }
     
 private:
-    std::vector<std::unique_ptr<CommandBase>>  commands;
-    std::vector<std::unique_ptr<NamespaceDef>> namespaces;
-    CacheMap                                   defCache;
+    enum class IndexLoad
+    {
+        Loaded,
+        NotStarted,
+        Failed
+    };
+    
+    struct PreRender
+    {
+        std::vector<const SymbolIndex::Entity*> classes;
+        std::atomic<std::size_t>                numRendered { 0 };
+    };
+    
+    //==================================================================================================================
+    std::vector<std::unique_ptr<CommandBase>> commands;
+    SymbolIndex                               symbolIndex;
+    DocumentIndex                             documentIndex;
     
     juce::String clientId;
     
@@ -116,21 +186,47 @@ private:
     juce::File dirJuce { dirRoot.getChildFile("juce/" + AppConfig::getInstance().branchName) };
     juce::File dirDocs { dirJuce.getChildFile("docs/doxygen") };
     
+    ShowCache showCache { static_cast<std::size_t>(AppConfig::getInstance().showCacheMiB) * 1024 * 1024 };
+    QueryLog  queryLog  { dirRoot.getChildFile("querylog.json") };
+    
+    GraphCache graphCache { dirRoot.getChildFile("graphs"),
+                            static_cast<std::int64_t>(AppConfig::getInstance().graphCacheMiB) * 1024 * 1024 };
+    
+    AttachmentCache attachmentCache;
+    
     std::atomic<bool> busy { false };
     
+    RateLimiter guildLimiter { AppConfig::getInstance().guildRate, AppConfig::getInstance().guildBurst };
+    RateLimiter userLimiter  { AppConfig::getInstance().userRate,  AppConfig::getInstance().userBurst  };
+    
+    // Declared last so that no queued job can outlive the data it works on
+    juce::ThreadPool workerPool { juce::jmax(2, juce::SystemStats::getNumCpus()) };
+    
+    // Finished renders hand their results over to the worker pool, so this one has to go first.
+    // One thread is enough, Graphviz isn't thread safe and renders take turns anyway.
+    RenderPool renderPool { 1, AppConfig::getInstance().graphQueue };
+    
     //==================================================================================================================
     juce::String getActivator() const;
     
     //==================================================================================================================
     void notifyBusy(const sld::Message&);
+    bool admitRequest(const sld::Message&);
+    
+    //==================================================================================================================
+    void sendPayload(sld::RequestMethod method, const sld::Route &route, const std::string &content,
+                     const std::vector<std::string> &embeds, const std::vector<juce::File> &files,
+                     std::function<void(sld::Response)> callback);
     
     //==================================================================================================================
     void showHelpPage(sld::Message&, const juce::String&);
     
     //==================================================================================================================
-    void initDoxygenEngine();
-    void parseDoxygenFiles();
     void createFileStructure();
+    IndexLoad loadIndexFromIndexer();
+    void warmUpCaches();
+    void preRenderGraphs();
+    void preRenderNext(std::shared_ptr<PreRender> preRender, std::size_t next);
     
     //==================================================================================================================
     void setupRepository() const;
@@ -3,10 +3,18 @@
 
 namespace
 {
-    void setOption(const juce::ArgumentList &args, std::string_view name, juce::String &valueToSet)
+    // Only the first few options have a short form, taken from their first letter, later ones would clash with them
+    void setOption(const juce::ArgumentList &args, std::string_view name, juce::String &valueToSet,
+                   bool withShortName = false)
     {
         juce::String opt_syntax;
-        opt_syntax << "-" << name[0] << "|--" << name.data();
+        
+        if (withShortName)
+        {
+            opt_syntax << "-" << name[0] << "|";
+        }
+        
+        opt_syntax << "--" << name.data();
         
         if (juce::String opt = args.getValueForOption(opt_syntax); !opt.isEmpty())
         {
@@ -19,11 +27,16 @@ namespace
         option = args.containsOption(juce::String("--") + name.data());
     }
     
-    void setOption(const juce::ArgumentList &args, std::string_view name, int &option)
+    void setOption(const juce::ArgumentList &args, std::string_view name, int &option, bool withShortName = false)
     {
         juce::String value;
-        setOption(args, name, value);
-        option = value.getIntValue();
+        setOption(args, name, value, withShortName);
+        
+        // Options that weren't given keep their default
+        if (value.isNotEmpty())
+        {
+            option = value.getIntValue();
+        }
     }
 }
 
@@ -35,8 +48,8 @@ int main(int argc, char *argv[])
     juce::String client_id;
     
     // Bot info
-    ::setOption(argument_list, "token", client_token);
-    ::setOption(argument_list, "id",    client_id);
+    ::setOption(argument_list, "token", client_token, true);
+    ::setOption(argument_list, "id",    client_id,    true);
     
     if (client_token.isEmpty())
     {
@@ -51,15 +64,98 @@ int main(int argc, char *argv[])
     AppConfig &config = AppConfig::getInstance();
     
     // App info
-    ::setOption(argument_list, "branch", config.branchName);
-    ::setOption(argument_list, "pcsize", config.pageCacheSize);
+    ::setOption(argument_list, "branch", config.branchName,    true);
+    ::setOption(argument_list, "pcsize", config.pageCacheSize, true);
     ::setOption(argument_list, "clone",  config.cloneOnStart);
+    ::setOption(argument_list, "stream", config.streamResults);
+    ::setOption(argument_list, "qtime",  config.queryTimeMs);
+    ::setOption(argument_list, "qwork",  config.queryWork);
+    
+    // Rate limits, requests per minute and how many can come at once
+    ::setOption(argument_list, "grate",  config.guildRate);
+    ::setOption(argument_list, "gburst", config.guildBurst);
+    ::setOption(argument_list, "urate",  config.userRate);
+    ::setOption(argument_list, "uburst", config.userBurst);
+    
+    // Caches
+    ::setOption(argument_list, "scsize", config.showCacheMiB);
+    ::setOption(argument_list, "wcount", config.warmUpCount);
+    ::setOption(argument_list, "wtime",  config.warmUpTimeMs);
+    
+    // Graphs, how many renders can wait before show leaves the graph out, how much disk the images can take, how
+    // far and wide they reach at most and whether show sends its text first and attaches the graphs later
+    ::setOption(argument_list, "gqueue",    config.graphQueue);
+    ::setOption(argument_list, "gcsize",    config.graphCacheMiB);
+    ::setOption(argument_list, "prerender", config.preRender);
+    ::setOption(argument_list, "gdepth",    config.graphDepth);
+    ::setOption(argument_list, "gwidth",    config.graphWidth);
+    ::setOption(argument_list, "twophase",  config.twoPhaseShow);
+    
+    // Parses with Doxygen's own settings for JUCE, everything the bot doesn't need included, for comparing against.
+    // Given a file, the first run writes its fingerprints in there and the next run refuses to start if its own
+    // don't match them, so running once with --fullparse and once without checks that both index the same.
+    ::setOption(argument_list, "fullparse",    config.fullParse);
+    ::setOption(argument_list, "fingerprints", config.fingerprints);
+    
+    // How many threads Doxygen parses the sources with, one by default just like Doxygen itself
+    ::setOption(argument_list, "threads", config.parseThreads);
+    
+    // Indexes in a jucedoc-indexer process next to this one and only maps what it wrote, or reuses what it wrote
+    // before for the same commit
+    ::setOption(argument_list, "indexer", config.useIndexer);
     
     if (config.pageCacheSize < 1)
     {
         config.pageCacheSize = AppInfo::defaultPageCacheSize;
     }
     
+    if (config.showCacheMiB < 1)
+    {
+        config.showCacheMiB = AppInfo::defaultShowCacheMiB;
+    }
+    
+    if (config.graphCacheMiB < 1)
+    {
+        config.graphCacheMiB = AppInfo::defaultGraphCacheMiB;
+    }
+    
+    if (config.graphDepth < 1)
+    {
+        config.graphDepth = AppInfo::defaultGraphDepth;
+    }
+    
+    if (config.graphWidth < 1)
+    {
+        config.graphWidth = AppInfo::defaultGraphWidth;
+    }
+    
+    if (config.graphQueue < 1)
+    {
+        config.graphQueue = AppInfo::defaultGraphQueue;
+    }
+    
+    if (config.queryTimeMs < 1)
+    {
+        config.queryTimeMs = AppInfo::defaultQueryTimeMs;
+    }
+    
+    if (config.queryWork < 1)
+    {
+        config.queryWork = AppInfo::defaultQueryWork;
+    }
+    
+    if (config.parseThreads < 1)
+    {
+        config.parseThreads = 1;
+    }
+    
+    // The bot works from the directory it sits in, the file is where it was given relative to
+    if (config.fingerprints.isNotEmpty())
+    {
+        config.fingerprints = juce::File::getCurrentWorkingDirectory().getChildFile(config.fingerprints)
+                                                                      .getFullPathName();
+    }
+    
     JuceDocClient client(client_token, client_id);
     client.setIntents(sld::Intent::SERVER_MESSAGES | sld::Intent::SERVER_MESSAGE_REACTIONS);
     client.run();
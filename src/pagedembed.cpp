@@ -2,12 +2,10 @@
 #include "pagedembed.h"
 
 #include "config.h"
-#include "linkresolve.h"
 
 // Doxygen
-#include <namespacedef.h>
-#include <classlist.h>
 #include <groupdef.h>
+#include <memberdef.h>
 // Sleepy-Discord
 #include <sleepy_discord/embed.h>
 // STL
@@ -16,46 +14,30 @@
 namespace
 {
     template<bool VIsFunc>
-    bool hasMemberSpecs(const MemberDef &member, const Filter &filter)
+    bool hasMemberSpecs(const SymbolIndex::Traits &traits, const Filter &filter)
     {
-        const ArgumentList &args = member.argumentList();
-    
-        if (const auto &linkage = filter.get<Filter::Linkage>();
-            !linkage.empty() && !linkage.contains(Linkage::values[static_cast<int>(member.isExternal())]))
+        if (const auto &linkage = filter.get<Filter::Linkage>(); !linkage.empty() && !linkage.contains(traits.linkage))
         {
             return false;
         }
         
-        if (const auto &vtype = filter.get<Filter::VType>();
-            !vtype.empty() && !vtype.contains(VarType::values[args.refQualifier()]))
+        if (const auto &vtype = filter.get<Filter::VType>(); !vtype.empty() && !vtype.contains(traits.refQualifier))
         {
             return false;
         }
-    
+        
+        if (const auto &quals = filter.get<Filter::Quals>(); !quals.empty() && !quals.contains(traits.qualification))
         {
-            const int qualification = static_cast<int>(args.constSpecifier())
-                                      + (static_cast<int>(args.volatileSpecifier()) * 2);
-            
-            if (const auto &quals = filter.get<Filter::Quals>();
-                !quals.empty() && !quals.contains(TypeQualifier::values[qualification]))
-            {
-                return false;
-            }
+            return false;
         }
         
         if (const auto &flag = filter.get<Filter::Constexpr>();
-            flag.isSet() && (member.isConstExpr() != flag.getValue()))
+            flag.isSet() && (traits.isConstexpr != flag.getValue()))
         {
             return false;
         }
         
-        const Ownership ownership = dynamic_cast<NamespaceDef*>(member.getOuterScope()) ? Ownership::Free
-                                                                    : member.isFriend() ? Ownership::Friend
-                                                                    : member.isStatic() ? Ownership::Static
-                                                                                        : Ownership::Member;
-        
-        if (const auto &mtype = filter.get<Filter::MType>();
-            !mtype.empty() && !mtype.contains(ownership))
+        if (const auto &mtype = filter.get<Filter::MType>(); !mtype.empty() && !mtype.contains(traits.ownership))
         {
             return false;
         }
@@ -63,7 +45,7 @@ namespace
         if constexpr (VIsFunc)
         {
             if (const auto &virtualness = filter.get<Filter::Virtual>();
-                !virtualness.empty() && !virtualness.contains(Virtualness::values[member.virtualness()]))
+                !virtualness.empty() && !virtualness.contains(traits.virtualness))
             {
                 return false;
             }
@@ -72,23 +54,29 @@ namespace
         return true;
     }
     
-    bool searchForBaseDfs(const std::vector<std::string_view> &bases, const ClassDef &clazz)
+    bool searchForBaseDfs(const std::vector<std::string_view> &bases, const SymbolIndex &index,
+                          SymbolIndex::EntityId id, QueryBudget &budget)
     {
-        for (const auto &base : clazz.baseClasses())
+        for (const auto &base : index.getBases(id))
         {
-            const ClassDef &base_def = *base.classDef;
+            if (!budget.consume())
+            {
+                return false;
+            }
+            
+            const juce::String &base_name = index.getEntity(base.id).qualifiedName;
             
-            for (const auto &base_name : bases)
+            for (const auto &name : bases)
             {
-                if (base_name == base_def.qualifiedName().data())
+                if (name == base_name.toRawUTF8())
                 {
                     return true;
                 }
             }
             
-            if (!base_def.baseClasses().empty())
+            if (!index.getBases(base.id).empty())
             {
-                if (searchForBaseDfs(bases, base_def))
+                if (searchForBaseDfs(bases, index, base.id, budget))
                 {
                     return true;
                 }
@@ -98,7 +86,8 @@ namespace
         return false;
     }
     
-    bool classHasBase(const ClassDef &clazz, const std::vector<juce::String> &bases)
+    bool classHasBase(const SymbolIndex &index, SymbolIndex::EntityId id, const std::vector<juce::String> &bases,
+                      QueryBudget &budget)
     {
         if (bases.empty())
         {
@@ -123,15 +112,20 @@ namespace
             }
         }
         
-        for (const auto &base : clazz.baseClasses())
+        for (const auto &base : index.getBases(id))
         {
-            const ClassDef &base_def = *base.classDef;
+            if (!budget.consume())
+            {
+                return false;
+            }
+            
+            const juce::String &base_name = index.getEntity(base.id).qualifiedName;
             
             for (const auto &vec : { &nested, &locals })
             {
-                for (const auto &base_name : *vec)
+                for (const auto &name : *vec)
                 {
-                    if (base_name == base_def.qualifiedName().data())
+                    if (name == base_name.toRawUTF8())
                     {
                         return true;
                     }
@@ -140,7 +134,7 @@ namespace
             
             if (!nested.empty())
             {
-                if (searchForBaseDfs(nested, base_def))
+                if (searchForBaseDfs(nested, index, base.id, budget))
                 {
                     return true;
                 }
@@ -152,74 +146,301 @@ namespace
     
     bool matches(const juce::String &term, std::string_view data, bool ignoreCase = false)
     {
-        return term.isEmpty() || juce::String(data.data()).matchesWildcard("*" + term + "*", ignoreCase);
+        return term.isEmpty() || juce::String::fromUTF8(data.data(), static_cast<int>(data.size()))
+                                     .matchesWildcard("*" + term + "*", ignoreCase);
+    }
+    
+    //==================================================================================================================
+    juce::String createListItem(const SymbolIndex &index, const SymbolIndex::Entity &entity, const juce::String &docUrl)
+    {
+        const Definition       &definition = *index.getDefinition(entity.id);
+        const std::string_view path        = index.getDocPath(entity.id);
+        
+        juce::String field_desc;
+        field_desc << "**Path:** " << definition.qualifiedName().data() << "\n"
+                   << "**Type:** " << entity.type->name()          .data() << "\n";
+        
+        juce::String module = "All";
+        
+        const Definition *group_def = &definition;
+        
+        if (dynamic_cast<const MemberDef*>(&definition))
+        {
+            group_def = definition.getOuterScope();
+        }
+        
+        if (group_def)
+        {
+            if (const auto &groups = group_def->partOfGroups(); !groups.empty() && group_def->localName() != "juce")
+            {
+                module.clear();
+                module << groups[0]->groupTitle().rawData() << " ("
+                       << juce::String(groups[0]->localName().data()).upToFirstOccurrenceOf("-", false, true) << ")";
+            }
+        }
+        else
+        {
+            module = "Unknown";
+        }
+        
+        field_desc << "**Module:** " << module << "\n";
+        
+        if (const Definition *scope = definition.getOuterScope())
+        {
+            field_desc << "**Parent:** " << scope->qualifiedName().data() << "\n";
+        }
+        else
+        {
+            field_desc << "**Parent:** None\n";
+        }
+        
+        juce::String description;
+        
+        if (definition.hasBriefDescription() && !definition.briefDescription().isEmpty())
+        {
+            description = juce::String(definition.briefDescription().data());
+        }
+        else if (definition.hasDocumentation() && !definition.documentation().isEmpty())
+        {
+            const juce::String doc = definition.documentation().data();
+            
+            description = juce::String(doc).substring(0, 60);
+            
+            if (doc.length() > 60)
+            {
+                description << "...";
+            }
+        }
+        
+        if (description.isEmpty() || description == "/internal")
+        {
+            description = "No docs available";
+        }
+        
+        field_desc << "**Doc:** " << description << "\n"
+                   << "[Go to official docs](" << docUrl << juce::String(path.data(), path.size()) << ")";
+        
+        return field_desc.substring(0, std::min(1024, field_desc.length()));
+    }
+}
+
+//**********************************************************************************************************************
+// region ResultSet
+//======================================================================================================================
+std::size_t PagedEmbed::ResultSet::waitFor(std::size_t numItems) const
+{
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this, numItems]() { return complete || available >= numItems; });
+    return available;
+}
+
+void PagedEmbed::ResultSet::whenComplete(std::function<void()> callback)
+{
+    {
+        const std::lock_guard lock(mutex);
+        
+        if (!complete)
+        {
+            onComplete.emplace_back(std::move(callback));
+            return;
+        }
+    }
+    
+    callback();
+}
+
+//======================================================================================================================
+std::vector<PagedEmbed::EntityId> PagedEmbed::ResultSet::getRange(std::size_t start, std::size_t count) const
+{
+    const std::lock_guard lock(mutex);
+    
+    if (start >= available)
+    {
+        return {};
     }
+    
+    const auto first = items.begin() + start;
+    return { first, first + std::min(count, available - start) };
 }
 
+std::size_t PagedEmbed::ResultSet::getNumAvailable() const
+{
+    const std::lock_guard lock(mutex);
+    return available;
+}
+
+bool PagedEmbed::ResultSet::isComplete() const
+{
+    const std::lock_guard lock(mutex);
+    return complete;
+}
+
+bool PagedEmbed::ResultSet::isTruncated() const
+{
+    const std::lock_guard lock(mutex);
+    return truncated;
+}
+
+//======================================================================================================================
+void PagedEmbed::ResultSet::append(const std::vector<EntityId> &newItems, bool publish)
+{
+    {
+        const std::lock_guard lock(mutex);
+        items.insert(items.end(), newItems.begin(), newItems.end());
+        
+        if (publish)
+        {
+            available = items.size();
+        }
+    }
+    
+    changed.notify_all();
+}
+
+void PagedEmbed::ResultSet::finish(bool wasTruncated)
+{
+    std::vector<std::function<void()>> callbacks;
+    
+    {
+        const std::lock_guard lock(mutex);
+        available = items.size();
+        complete  = true;
+        truncated = wasTruncated;
+        std::swap(callbacks, onComplete);
+    }
+    
+    changed.notify_all();
+    
+    for (const auto &callback : callbacks)
+    {
+        callback();
+    }
+}
+//======================================================================================================================
+// endregion ResultSet
 //**********************************************************************************************************************
 // region PagedEmbed
 //======================================================================================================================
-PagedEmbed::PagedEmbed(const sld::Snowflake<sld::Channel> &channelId, Filter filter)
-    : filter(std::move(filter)), channelId(channelId)
+void PagedEmbed::prepareListItems(SymbolIndex &index)
+{
+    const juce::String doc_url = AppInfo::urlJuceDocsBase.data() + AppConfig::getInstance().branchName + "/";
+    
+    for (EntityId id = 0; id < index.size(); ++id)
+    {
+        const SymbolIndex::Entity &entity = index.getEntity(id);
+        const juce::String        item    = ::createListItem(index, entity, doc_url);
+        
+        index.setListItem(id, index.getDefinition(id)->localName().str(), item.toRawUTF8());
+    }
+    
+    index.shrinkListItems();
+}
+
+//======================================================================================================================
+PagedEmbed::PagedEmbed(const sld::Snowflake<sld::Channel> &channelId, const SymbolIndex &index, Filter filter)
+    : index(&index), filter(std::move(filter)), channelId(channelId)
 {}
 
 //======================================================================================================================
-void PagedEmbed::applyListWithFilter(const CacheMap &cache, const juce::String &term)
+void PagedEmbed::applyListWithFilter(const juce::String &term, QueryBudget budget)
 {
+    static constexpr std::size_t publish_batch_size = 256;
+    
     // Filters
-    const std::string_view            &class_path = filter.get<Filter::CPath>().toRawUTF8();
-    const venum::VenumSet<EntityType> &types      = filter.get<Filter::Entity>();
+    const std::string_view            &class_path  = filter.get<Filter::CPath>().toRawUTF8();
+    const venum::VenumSet<EntityType> &types       = filter.get<Filter::Entity>();
+    const SortType                    &sort_type   = filter.get<Filter::Sort>();
+    const juce::String                &param_type  = filter.get<Filter::Param>();
+    const juce::String                &return_type = filter.get<Filter::Returns>();
+    
+    // Only functions have a signature, everything else is left out as soon as one is asked for
+    const bool by_signature = param_type.isNotEmpty() || return_type.isNotEmpty();
+    
+    // Alphabetic results can't be shown before every hit is known, all others can go out as soon as they are found
+    const bool  in_order = !sort_type || sort_type == SortType::Entity;
+    std::size_t num_published = 0;
+    
+    std::vector<EntityId> batch;
+    const auto flush = [this, in_order, &batch, &num_published]()
+    {
+        num_published += batch.size();
+        results->append(batch, in_order);
+        batch.clear();
+    };
     
-    if (types.contains(EntityType::Namespace))
+    const auto add_result = [this, &batch, &num_published, &flush](EntityId id)
     {
-        for (const auto &def : cache[EntityType::Namespace])
+        batch.emplace_back(id);
+        
+        if (batch.size() >= (num_published == 0 ? static_cast<std::size_t>(maxItemsPerPage) : publish_batch_size))
+        {
+            flush();
+        }
+    };
+    
+    if (types.contains(EntityType::Namespace) && !by_signature)
+    {
+        for (const auto &id : index->getEntities(EntityType::Namespace))
         {
-            const auto &ns_def = static_cast<const NamespaceDef&>(def.get());
+            if (!budget.consume())
+            {
+                break;
+            }
             
-            if (ns_def.qualifiedName().startsWith(class_path.data())
-                && ::matches(term, ns_def.localName().data()))
+            if (index->getEntity(id).qualifiedName.startsWith(class_path.data())
+                && ::matches(term, index->getListItem(id).name))
             {
-                (void) resultCache.emplace_back(EntityType::Namespace, ns_def);
+                add_result(id);
             }
         }
     }
     
-    if (types.contains(EntityType::Class))
+    if (types.contains(EntityType::Class) && !by_signature)
     {
         const venum::VenumSet<CompoundType> &ctypes = filter.get<Filter::CType>();
         const std::vector<juce::String>     &bases  = filter.get<Filter::Bases>();
         
-        for (const auto &def : cache[EntityType::Class])
+        for (const auto &id : index->getEntities(EntityType::Class))
         {
-            const auto &cs_def = static_cast<const ClassDef&>(def.get());
-            if (cs_def.qualifiedName().startsWith(class_path.data())
-                && ::matches(term, cs_def.localName().data())
-                && ::classHasBase(cs_def, bases))
+            if (!budget.consume())
             {
-                if (ctypes.contains(CompoundType::valueOf(cs_def.compoundTypeString().str(), true)))
+                break;
+            }
+            
+            const SymbolIndex::Entity &entity = index->getEntity(id);
+            
+            if (entity.qualifiedName.startsWith(class_path.data())
+                && ::matches(term, index->getListItem(id).name)
+                && ::classHasBase(*index, id, bases, budget))
+            {
+                if (ctypes.contains(entity.traits.compoundType))
                 {
-                    (void) resultCache.emplace_back(EntityType::Class, cs_def);
+                    add_result(id);
                 }
             }
         }
     }
     
-    if (types.contains(EntityType::Enum))
+    if (types.contains(EntityType::Enum) && !by_signature)
     {
         // Filters
         const venum::VenumSet<CompoundType> &ctypes = filter.get<Filter::CType>();
         
-        for (const auto &def : cache[EntityType::Enum])
+        for (const auto &id : index->getEntities(EntityType::Enum))
         {
-            const auto &en_def = static_cast<const MemberDef&>(def.get());
+            if (!budget.consume())
+            {
+                break;
+            }
+            
+            const SymbolIndex::Entity &entity = index->getEntity(id);
             
-            if (en_def.qualifiedName().startsWith(class_path.data())
-                && ::matches(term, en_def.localName().data()))
+            if (entity.qualifiedName.startsWith(class_path.data())
+                && ::matches(term, index->getListItem(id).name))
             {
-                if (en_def.isEnumStruct() ? ctypes.contains(CompoundType::EnumClass)
-                                          : ctypes.contains(CompoundType::Enum))
+                if (ctypes.contains(entity.traits.compoundType))
                 {
-                    (void) resultCache.emplace_back(EntityType::Enum, en_def);
+                    add_result(id);
                 }
             }
         }
@@ -227,207 +448,218 @@ void PagedEmbed::applyListWithFilter(const CacheMap &cache, const juce::String &
     
     if (types.contains(EntityType::Function))
     {
-        for (const auto &def : cache[EntityType::Function])
+        const auto check_function = [&](EntityId id)
         {
-            const auto &fn_def = static_cast<const MemberDef&>(def.get());
+            if (!budget.consume())
+            {
+                return false;
+            }
+            
+            const SymbolIndex::Entity &entity = index->getEntity(id);
             
-            if ((fn_def.qualifiedName().startsWith(class_path.data()))
-                && ::hasMemberSpecs<true>(fn_def, filter)
-                && ::matches(term, fn_def.localName().data()))
+            if (entity.qualifiedName.startsWith(class_path.data())
+                && ::hasMemberSpecs<true>(entity.traits, filter)
+                && ::matches(term, index->getListItem(id).name))
             {
-                (void) resultCache.emplace_back(EntityType::Function, fn_def);
+                add_result(id);
+            }
+            
+            return true;
+        };
+        
+        if (by_signature)
+        {
+            // Only the functions the signature index knows about need to be looked at
+            for (const auto &id : index->findBySignature(param_type, return_type))
+            {
+                if (!check_function(id))
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            for (const auto &id : index->getEntities(EntityType::Function))
+            {
+                if (!check_function(id))
+                {
+                    break;
+                }
             }
         }
     }
     
-    if (types.contains(EntityType::Field))
+    if (types.contains(EntityType::Field) && !by_signature)
     {
-        for (const auto &def : cache[EntityType::Field])
+        for (const auto &id : index->getEntities(EntityType::Field))
         {
-            const auto &var_def = static_cast<const MemberDef&>(def.get());
+            if (!budget.consume())
+            {
+                break;
+            }
+            
+            const SymbolIndex::Entity &entity = index->getEntity(id);
             
-            if ((var_def.qualifiedName().startsWith(class_path.data()))
-                && ::hasMemberSpecs<false>(var_def, filter)
-                && ::matches(term, var_def.localName().data()))
+            if (entity.qualifiedName.startsWith(class_path.data())
+                && ::hasMemberSpecs<false>(entity.traits, filter)
+                && ::matches(term, index->getListItem(id).name))
             {
-                (void) resultCache.emplace_back(EntityType::Field, var_def);
+                add_result(id);
             }
         }
     }
     
-    if (types.contains(EntityType::TypeAlias))
+    if (types.contains(EntityType::TypeAlias) && !by_signature)
     {
-        for (const auto &def : cache[EntityType::TypeAlias])
+        for (const auto &id : index->getEntities(EntityType::TypeAlias))
         {
-            const auto &aka_def = static_cast<const MemberDef&>(def.get());
+            if (!budget.consume())
+            {
+                break;
+            }
             
-            if (aka_def.qualifiedName().startsWith(class_path.data())
-                && ::matches(term, aka_def.localName().data()))
+            if (index->getEntity(id).qualifiedName.startsWith(class_path.data())
+                && ::matches(term, index->getListItem(id).name))
             {
-                (void) resultCache.emplace_back(EntityType::TypeAlias, aka_def);
+                add_result(id);
             }
         }
     }
     
-    if (const auto &sort_type = filter.get<Filter::Sort>())
+    flush();
+    
+    if (!in_order)
     {
-        if (sort_type == SortType::Asc)
+        const auto compare = [this, ascending = (sort_type == SortType::Asc)](EntityId a, EntityId b)
         {
-            std::sort(resultCache.begin(), resultCache.end(), [](const auto &a, const auto &b)
-            {
-                return a.second.get().qualifiedName() < b.second.get().qualifiedName();
-            });
-        }
-        else if (sort_type == SortType::Desc)
+            const juce::String &name_a = index->getEntity(a).qualifiedName;
+            const juce::String &name_b = index->getEntity(b).qualifiedName;
+            return ascending ? name_a < name_b : name_b < name_a;
+        };
+        
+        // Sort the first page on its own so it can be shown while the rest is still being sorted
+        ResultSet   &set       = *results;
+        std::size_t first_page = 0;
+        
         {
-            std::sort(resultCache.begin(), resultCache.end(), [](const auto &a, const auto &b)
-            {
-                return b.second.get().qualifiedName() < a.second.get().qualifiedName();
-            });
+            const std::lock_guard lock(set.mutex);
+            
+            first_page = std::min<std::size_t>(maxItemsPerPage, set.items.size());
+            std::partial_sort(set.items.begin(), set.items.begin() + first_page, set.items.end(), compare);
+            set.available = first_page;
         }
+        
+        set.changed.notify_all();
+        
+        // Readers never look past the available items and the vector doesn't grow anymore, so the rest can be
+        // sorted without holding the lock
+        std::sort(set.items.begin() + first_page, set.items.end(), compare);
     }
+    
+    // Whatever was found until the budget ran out is still worth showing, it's just flagged as partial
+    results->finish(budget.isExhausted());
+}
+
+void PagedEmbed::applyResults(const std::vector<EntityId> &ids)
+{
+    results->append(ids, true);
+    results->finish(false);
 }
 
 //======================================================================================================================
 sld::Snowflake<sld::Channel> PagedEmbed::getChannelId() const noexcept { return channelId; }
 sld::Snowflake<sld::Message> PagedEmbed::getMessageId() const noexcept { return messageId; }
 int PagedEmbed::getMaxItemsPerPage()                    const noexcept { return maxItemsPerPage; }
-int PagedEmbed::getNumItems()                           const noexcept { return resultCache.size(); }
+int PagedEmbed::getNumItems()                           const { return static_cast<int>(results->getNumAvailable()); }
 
-int PagedEmbed::getMaxPages() const noexcept
+int PagedEmbed::getMaxPages() const
 {
-    return std::max<int>(1, std::ceil(resultCache.size() / static_cast<double>(maxItemsPerPage)));
+    return std::max<int>(1, std::ceil(getNumItems() / static_cast<double>(maxItemsPerPage)));
 }
 
+bool PagedEmbed::isComplete() const { return results->isComplete(); }
+
 //======================================================================================================================
 void PagedEmbed::setMaxItemsPerPage(int newMaxItemsPerPage) noexcept { maxItemsPerPage = newMaxItemsPerPage; }
 
 void PagedEmbed::setMessageId(sld::Snowflake<sld::Message> parMessageId) { std::swap(messageId, parMessageId); }
 
 //======================================================================================================================
-void PagedEmbed::prevPage() noexcept
+bool PagedEmbed::prevPage()
 {
     currentPage = std::clamp(currentPage - 1, 0, getMaxPages() - 1);
+    return true;
 }
 
-void PagedEmbed::nextPage() noexcept
+bool PagedEmbed::nextPage()
 {
+    // Completion is checked first, a finished query has everything available
+    const bool complete = results->isComplete();
+    
+    if (!complete && results->getNumAvailable() <= static_cast<std::size_t>((currentPage + 1) * maxItemsPerPage))
+    {
+        return false;
+    }
+    
     currentPage = std::clamp(currentPage + 1, 0, getMaxPages() - 1);
+    return true;
 }
 
-void PagedEmbed::setPage(PageAction action) noexcept
+bool PagedEmbed::setPage(PageAction action)
 {
-    if (action == PageAction::Back)
-    {
-        prevPage();
-    }
-    else if (action == PageAction::Forward)
-    {
-        nextPage();
-    }
+    return (action == PageAction::Back ? prevPage() : nextPage());
 }
 
 //======================================================================================================================
 void PagedEmbed::reset()
 {
-    resultCache.clear();
+    results     = std::make_shared<ResultSet>();
+    currentPage = 0;
 }
 
 //======================================================================================================================
 sld::Embed PagedEmbed::toEmbed(const juce::String &title, std::uint32_t colour) const
 {
-    const int num_items   = std::min<int>(resultCache.size() - (currentPage * maxItemsPerPage), maxItemsPerPage);
-    const int start_index = currentPage * maxItemsPerPage;
+    const int                   start_index = currentPage * maxItemsPerPage;
+    const bool                  complete    = results->isComplete();
+    const std::vector<EntityId> page_items  = results->getRange(start_index, maxItemsPerPage);
+    const int                   num_items   = static_cast<int>(page_items.size());
+    
+    // Totals are only known once the query has finished, until then they are shown as lower bounds
+    const std::string max_pages = complete ? std::to_string(getMaxPages()) : "?";
+    const std::string of_items  = std::to_string(getNumItems()) + (complete ? "" : "+");
     
     sld::Embed embed;
     embed.title = title.toRawUTF8();
     embed.color = colour;
-    embed.fields.reserve(3 + num_items);
-    embed.fields.emplace_back("Page",  std::to_string(currentPage + 1) + "/" + std::to_string(getMaxPages()), true);
+    embed.fields.reserve(4 + num_items);
+    embed.fields.emplace_back("Page",  std::to_string(currentPage + 1) + "/" + max_pages, true);
     embed.fields.emplace_back("Items",
                               std::to_string(start_index + static_cast<int>(maxItemsPerPage > 0)) + " to "
                                   + std::to_string(start_index + num_items),
                               true);
-    embed.fields.emplace_back("Of", std::to_string(getNumItems()), true);
+    embed.fields.emplace_back("Of", of_items, true);
     
-    for (int i = start_index; i < (start_index + num_items); ++i)
+    for (const auto &id : page_items)
     {
-        const ResultDef &def = resultCache[i];
-        
-        juce::String field_desc;
-        field_desc << "**Path:** " << def.second.get().qualifiedName().data() << "\n"
-                   << "**Type:** " << def.first->name()               .data() << "\n";
-        
-        juce::String module = "All";
-    
-        const Definition *group_def = &def.second.get();
-    
-        if (dynamic_cast<const MemberDef*>(&def.second.get()))
-        {
-            group_def = def.second.get().getOuterScope();
-        }
-    
-        if (group_def)
-        {
-            if (const auto &groups = group_def->partOfGroups(); !groups.empty() && group_def->localName() != "juce")
-            {
-                module.clear();
-                module << groups[0]->groupTitle().rawData() << " ("
-                       << juce::String(groups[0]->localName().data()).upToFirstOccurrenceOf("-", false, true) << ")";
-            }
-        }
-        else
-        {
-            module = "Unknown";
-        }
-        
-        field_desc << "**Module:** " << module << "\n";
-        
-        if (const Definition *scope = def.second.get().getOuterScope())
-        {
-            field_desc << "**Parent:** " << scope->qualifiedName().data() << "\n";
-        }
-        else
-        {
-            field_desc << "**Parent:** None\n";
-        }
-        
-        juce::String description;
-        
-        if (def.second.get().hasBriefDescription() && !def.second.get().briefDescription().isEmpty())
-        {
-            description = juce::String(def.second.get().briefDescription().data());
-        }
-        else if (def.second.get().hasDocumentation() && !def.second.get().documentation().isEmpty())
-        {
-            const juce::String doc = def.second.get().documentation().data();
-    
-            description = juce::String(doc).substring(0, 60);
-            
-            if (doc.length() > 60)
-            {
-                description << "...";
-            }
-        }
-        
-        if (description.isEmpty() || description == "/internal")
-        {
-            description = "No docs available";
-        }
-        
-        const AppConfig    &config = AppConfig::getInstance();
-        const juce::String doc_url = AppInfo::urlJuceDocsBase.data() + config.branchName + "/";
-        field_desc << "**Doc:** " << description << "\n"
-                   << "[Go to official docs](" << doc_url << ::getUrlFromEntity(def.first, def.second) << ")";
-        field_desc = field_desc.substring(0, std::min(1024, field_desc.length()));
-    
-        embed.footer.iconUrl = AppIcon::LogoGitHub.getUrl();
-        embed.timestamp      = config.currentCommit.date.toStdString();
-        embed.footer.text    = config.currentCommit.name.substring(0, 9).toStdString()
-                               + " (" + config.branchName.toStdString() + ")";
+        const SymbolIndex::ListItem item = index->getListItem(id);
+        embed.fields.emplace_back(std::string(item.name), std::string(item.value), false);
+    }
     
+    if (num_items > 0)
+    {
+        const AppConfig &config = AppConfig::getInstance();
+        embed.footer.iconUrl    = AppIcon::LogoGitHub.getUrl();
+        embed.timestamp         = config.currentCommit.date.toStdString();
+        embed.footer.text       = config.currentCommit.name.substring(0, 9).toStdString()
+                                  + " (" + config.branchName.toStdString() + ")";
+    }
     
-        embed.fields.emplace_back(def.second.get().localName().data(), field_desc.toRawUTF8(), false);
+    if (complete && results->isTruncated())
+    {
+        embed.fields.emplace_back("Incomplete", "The query took too long and was stopped early, "
+                                                "narrow it down with more filters to see everything.", false);
     }
     
     return embed;
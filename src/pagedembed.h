@@ -3,11 +3,17 @@
 
 #include "filter.h"
 #include "polyspan.h"
+#include "querybudget.h"
+#include "symbolindex.h"
 
 #include <sleepy_discord/snowflake.h>
 
 #include <type_traits>
 #include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <variant>
 
 #include "namespacedef.h"
@@ -31,40 +37,90 @@ namespace SleepyDiscord
 //======================================================================================================================
 class PagedEmbed
 {
-private:
-    using ResultDef = std::pair<EntityType, std::reference_wrapper<const Definition>>;
-    using ResultVec = std::vector<ResultDef>;
-    using CacheMap  = venum::VenumMap<EntityType, std::vector<std::reference_wrapper<const Definition>>>;
-    
 public:
+    using EntityId = SymbolIndex::EntityId;
+    
+    //==================================================================================================================
+    /**
+     *  The results of one query, shared between all copies of the PagedEmbed that asked for it.
+     *  Results can be published while the query is still running, only the first getNumAvailable() items are final.
+     *  Only the scan that created a set writes to it, so it can be handed to any number of readers.
+     */
+    class ResultSet
+    {
+    public:
+        std::size_t waitFor(std::size_t numItems) const;
+        void        whenComplete(std::function<void()> callback);
+        
+        //==============================================================================================================
+        std::vector<EntityId> getRange(std::size_t start, std::size_t count) const;
+        std::size_t           getNumAvailable() const;
+        bool                  isComplete()      const;
+        bool                  isTruncated()     const;
+        
+    private:
+        friend class PagedEmbed;
+        
+        //==============================================================================================================
+        std::vector<EntityId>              items;
+        std::size_t                        available { 0 };
+        bool                               complete  { false };
+        bool                               truncated { false };
+        std::vector<std::function<void()>> onComplete;
+        
+        mutable std::mutex              mutex;
+        mutable std::condition_variable changed;
+        
+        //==============================================================================================================
+        void append(const std::vector<EntityId> &newItems, bool publish);
+        void finish(bool wasTruncated);
+    };
+    
+    //==================================================================================================================
     static constexpr std::string_view emoteLastPage = u8"⬅️";
     static constexpr std::string_view emoteNextPage = u8"➡️";
     
     //==================================================================================================================
     enum class PageAction { Back, Forward };
     
+    //==================================================================================================================
+    /**
+     *  Renders the field of every entity in the index ahead of time, toEmbed only copies these.
+     *  This reads from Doxygen's definitions, so it has to happen before the index lets go of them.
+     */
+    static void prepareListItems(SymbolIndex &index);
+    
     //==================================================================================================================
     PagedEmbed() = default;
-    explicit PagedEmbed(const sld::Snowflake<sld::Channel> &channelId, Filter filter = {});
+    PagedEmbed(const sld::Snowflake<sld::Channel> &channelId, const SymbolIndex &index, Filter filter = {});
     
     //==================================================================================================================
-    void applyListWithFilter(const CacheMap &cache, const juce::String &term);
+    void applyListWithFilter(const juce::String &term, QueryBudget budget = {});
+    void applyResults(const std::vector<EntityId> &ids);
     
     //==================================================================================================================
     sld::Snowflake<sld::Channel> getChannelId() const noexcept;
     sld::Snowflake<sld::Message> getMessageId() const noexcept;
     int getMaxItemsPerPage()                    const noexcept;
-    int getNumItems()                           const noexcept;
-    int getMaxPages()                           const noexcept;
+    int getNumItems()                           const;
+    int getMaxPages()                           const;
+    bool isComplete()                           const;
+    
+    //==================================================================================================================
+    ResultSet&                 getResults()             noexcept { return *results; }
+    std::shared_ptr<ResultSet> getSharedResults() const noexcept { return results; }
+    
+    void shareResults(std::shared_ptr<ResultSet> sharedResults) noexcept { results = std::move(sharedResults); }
     
     //==================================================================================================================
     void setMaxItemsPerPage(int newMaxItemsPerPage) noexcept;
     void setMessageId(sld::Snowflake<sld::Message> messageId);
     
     //==================================================================================================================
-    void prevPage()          noexcept;
-    void nextPage()          noexcept;
-    void setPage(PageAction) noexcept;
+    /** Never waits for a query that is still running, returns false if the page asked for isn't filled yet. */
+    bool prevPage();
+    bool nextPage();
+    bool setPage(PageAction);
     
     //==================================================================================================================
     void reset();
@@ -73,8 +129,9 @@ public:
     sld::Embed toEmbed(const juce::String &title, std::uint32_t = 0) const;
     
 private:
-    ResultVec resultCache;
-    Filter    filter;
+    std::shared_ptr<ResultSet> results { std::make_shared<ResultSet>() };
+    const SymbolIndex          *index  { nullptr };
+    Filter                     filter;
     
     sld::Snowflake<sld::Channel> channelId;
     sld::Snowflake<sld::Message> messageId;
@@ -82,4 +139,3 @@ private:
     int maxItemsPerPage { 10 };
     int currentPage     {  0 };
 };
-
@@ -0,0 +1,180 @@
+
+#include "prefixtrie.h"
+
+// STL
+#include <algorithm>
+
+//**********************************************************************************************************************
+// region PrefixTrie
+//======================================================================================================================
+void PrefixTrie::build(std::vector<Entry> entries, const Ranker &staticRank)
+{
+    nodes.clear();
+    keys.clear();
+    topValues.clear();
+    
+    if (entries.empty())
+    {
+        return;
+    }
+    
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+    
+    keys.reserve(entries.size());
+    
+    for (auto &entry : entries)
+    {
+        keys.emplace_back(std::move(entry.key));
+    }
+    
+    nodes.emplace_back();
+    buildNode(0, 0, static_cast<std::uint32_t>(keys.size()), 0, entries, staticRank);
+    
+    nodes.shrink_to_fit();
+    topValues.shrink_to_fit();
+}
+
+//======================================================================================================================
+std::vector<PrefixTrie::ValueId> PrefixTrie::getTopValues(std::string_view prefix) const
+{
+    if (nodes.empty())
+    {
+        return {};
+    }
+    
+    std::uint32_t index    = 0;
+    std::size_t   position = 0;
+    
+    for (;;)
+    {
+        const Node             &node  = nodes[index];
+        const std::string_view label  = getLabel(node);
+        const std::size_t      length = std::min(label.size(), prefix.size() - position);
+        
+        if (prefix.compare(position, length, label.substr(0, length)) != 0)
+        {
+            return {};
+        }
+        
+        position += length;
+        
+        if (position == prefix.size())
+        {
+            const auto top_begin = topValues.begin() + node.topStart;
+            return { top_begin, top_begin + node.topCount };
+        }
+        
+        const auto          first = nodes.begin() + node.firstChild;
+        const auto          last  = first + node.numChildren;
+        const unsigned char next  = static_cast<unsigned char>(prefix[position]);
+        
+        const auto it = std::lower_bound(first, last, next, [this](const Node &child, unsigned char c)
+        {
+            return getFirstChar(child) < c;
+        });
+        
+        if (it == last || getFirstChar(*it) != next)
+        {
+            return {};
+        }
+        
+        index = static_cast<std::uint32_t>(std::distance(nodes.begin(), it));
+    }
+}
+
+//======================================================================================================================
+void PrefixTrie::buildNode(std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t last, std::uint32_t depth,
+                           const std::vector<Entry> &entries, const Ranker &staticRank)
+{
+    // Keys are sorted, so the common prefix of the whole range is the common prefix of its first and last key
+    const std::string &low    = keys[first];
+    const std::string &high   = keys[last - 1];
+    const std::size_t  limit  = std::min(low.size(), high.size());
+    std::uint32_t      common = depth;
+    
+    while (common < limit && low[common] == high[common])
+    {
+        ++common;
+    }
+    
+    nodes[nodeIndex].keyIndex    = first;
+    nodes[nodeIndex].labelStart  = depth;
+    nodes[nodeIndex].labelLength = common - depth;
+    
+    std::vector<ValueId> candidates;
+    std::uint32_t        begin = first;
+    
+    if (low.size() == common)
+    {
+        candidates = entries[first].values;
+        ++begin;
+    }
+    
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> groups;
+    
+    for (std::uint32_t i = begin; i < last;)
+    {
+        std::uint32_t j = i + 1;
+        
+        while (j < last && keys[j][common] == keys[i][common])
+        {
+            ++j;
+        }
+        
+        groups.emplace_back(i, j);
+        i = j;
+    }
+    
+    const auto child_start = static_cast<std::uint32_t>(nodes.size());
+    nodes[nodeIndex].firstChild  = child_start;
+    nodes[nodeIndex].numChildren = static_cast<std::uint32_t>(groups.size());
+    nodes.resize(nodes.size() + groups.size());
+    
+    for (std::uint32_t i = 0; i < groups.size(); ++i)
+    {
+        buildNode(child_start + i, groups[i].first, groups[i].second, common, entries, staticRank);
+        
+        const Node &child     = nodes[child_start + i];
+        const auto  top_begin = topValues.begin() + child.topStart;
+        candidates.insert(candidates.end(), top_begin, top_begin + child.topCount);
+    }
+    
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    
+    std::vector<std::pair<float, ValueId>> ranked;
+    ranked.reserve(candidates.size());
+    
+    for (const auto &value : candidates)
+    {
+        ranked.emplace_back(staticRank(value), value);
+    }
+    
+    const std::size_t count = std::min(ranked.size(), maxTopValues);
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), [](const auto &a, const auto &b)
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+    
+    nodes[nodeIndex].topStart = static_cast<std::uint32_t>(topValues.size());
+    nodes[nodeIndex].topCount = static_cast<std::uint8_t>(count);
+    
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        topValues.emplace_back(ranked[i].second);
+    }
+}
+
+//======================================================================================================================
+std::string_view PrefixTrie::getLabel(const Node &node) const noexcept
+{
+    return std::string_view(keys[node.keyIndex]).substr(node.labelStart, node.labelLength);
+}
+
+unsigned char PrefixTrie::getFirstChar(const Node &node) const noexcept
+{
+    return static_cast<unsigned char>(keys[node.keyIndex][node.labelStart]);
+}
+//======================================================================================================================
+// endregion PrefixTrie
+//**********************************************************************************************************************
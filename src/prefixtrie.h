@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//======================================================================================================================
+/**
+ *  A path compressed trie over a fixed set of keys, built once from sorted input.
+ *  Every node keeps the best few values of its whole subtree, so a prefix lookup never has to walk the subtree.
+ */
+class PrefixTrie
+{
+public:
+    using ValueId = std::uint32_t;
+    using Ranker  = std::function<float(ValueId)>;
+    
+    //==================================================================================================================
+    struct Entry
+    {
+        std::string          key;
+        std::vector<ValueId> values;
+    };
+    
+    //==================================================================================================================
+    static constexpr std::size_t maxResults   = 10;
+    
+    // Kept well above what can be asked for, so that popularity can still lift values the static rank put lower
+    static constexpr std::size_t maxTopValues = 4 * maxResults;
+    
+    //==================================================================================================================
+    void build(std::vector<Entry> entries, const Ranker &staticRank);
+    
+    //==================================================================================================================
+    std::vector<ValueId> getTopValues(std::string_view prefix) const;
+    
+    //==================================================================================================================
+    std::size_t getNumNodes() const noexcept { return nodes.size(); }
+    
+private:
+    struct Node
+    {
+        std::uint32_t keyIndex    {};
+        std::uint32_t labelStart  {};
+        std::uint32_t labelLength {};
+        std::uint32_t firstChild  {};
+        std::uint32_t numChildren {};
+        std::uint32_t topStart    {};
+        std::uint8_t  topCount    {};
+    };
+    
+    //==================================================================================================================
+    std::vector<Node>        nodes;
+    std::vector<std::string> keys;
+    std::vector<ValueId>     topValues;
+    
+    //==================================================================================================================
+    void buildNode(std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t last, std::uint32_t depth,
+                   const std::vector<Entry> &entries, const Ranker &staticRank);
+    
+    std::string_view getLabel(const Node &node) const noexcept;
+    unsigned char    getFirstChar(const Node &node) const noexcept;
+};
@@ -0,0 +1,105 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+
+//======================================================================================================================
+/**
+ *  A time and work allowance for one command, checked cooperatively by whatever loop does the work.
+ *  Copies share the same allowance, so a query split over several threads or handed to a worker stays bounded.
+ *  A default constructed budget is unlimited.
+ */
+class QueryBudget
+{
+public:
+    QueryBudget() = default;
+    
+    QueryBudget(int timeLimitMs, std::int64_t workLimit)
+        : state(std::make_shared<State>(juce::Time::getMillisecondCounterHiRes() + timeLimitMs, workLimit))
+    {}
+    
+    //==================================================================================================================
+    bool consume(std::int64_t units = 1) noexcept
+    {
+        if (!state)
+        {
+            return true;
+        }
+        
+        if (state->exhausted.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        
+        const std::int64_t used = state->workUsed.fetch_add(units, std::memory_order_relaxed) + units;
+        
+        // The clock is only asked every few units, the loops using this are hot
+        if (used > state->workLimit || ((used & (clockInterval - 1)) < units && isPastDeadline()))
+        {
+            state->exhausted.store(true, std::memory_order_relaxed);
+            return false;
+        }
+        
+        return true;
+    }
+    
+    /** Checks the deadline right away, for places that do a lot of work per step. */
+    bool check() noexcept
+    {
+        if (!state)
+        {
+            return true;
+        }
+        
+        if (isPastDeadline())
+        {
+            cancel();
+        }
+        
+        return !isExhausted();
+    }
+    
+    void cancel() noexcept
+    {
+        if (state)
+        {
+            state->exhausted.store(true, std::memory_order_relaxed);
+        }
+    }
+    
+    //==================================================================================================================
+    bool isExhausted() const noexcept { return state && state->exhausted.load(std::memory_order_relaxed); }
+    
+    /** How much time is left before the deadline, infinite for an unlimited budget. */
+    double getRemainingMs() const noexcept
+    {
+        return (state ? state->deadline - juce::Time::getMillisecondCounterHiRes()
+                      : std::numeric_limits<double>::infinity());
+    }
+    
+private:
+    struct State
+    {
+        State(double parDeadline, std::int64_t parWorkLimit) : deadline(parDeadline), workLimit(parWorkLimit) {}
+        
+        //==============================================================================================================
+        const double       deadline;
+        const std::int64_t workLimit;
+        
+        std::atomic<std::int64_t> workUsed  { 0 };
+        std::atomic<bool>         exhausted { false };
+    };
+    
+    //==================================================================================================================
+    static constexpr std::int64_t clockInterval = 64;
+    
+    //==================================================================================================================
+    std::shared_ptr<State> state;
+    
+    //==================================================================================================================
+    bool isPastDeadline() const noexcept { return juce::Time::getMillisecondCounterHiRes() > state->deadline; }
+};
@@ -0,0 +1,97 @@
+
+#include "querylog.h"
+
+// STL
+#include <algorithm>
+
+//**********************************************************************************************************************
+// region QueryLog
+//======================================================================================================================
+QueryLog::QueryLog(juce::File parFile)
+    : file(std::move(parFile))
+{}
+
+//======================================================================================================================
+void QueryLog::load()
+{
+    const juce::var data = juce::JSON::parse(file);
+    
+    if (const juce::DynamicObject *const object = data.getDynamicObject())
+    {
+        const juce::ScopedLock scoped_lock(lock);
+        
+        for (const auto &property : object->getProperties())
+        {
+            counts[property.name.toString()] = static_cast<int>(property.value);
+        }
+    }
+}
+
+void QueryLog::save()
+{
+    // Saves can be asked for from more than one thread, they write one after the other and the last one wins
+    const juce::ScopedLock   file_lock(fileLock);
+    juce::DynamicObject::Ptr object = new juce::DynamicObject();
+    
+    {
+        const juce::ScopedLock scoped_lock(lock);
+        
+        if (numUnsaved == 0)
+        {
+            return;
+        }
+        
+        // Only the most frequent ones are kept, the rest would never be replayed anyway
+        const std::vector<std::pair<juce::String, int>> sorted = getSortedCounts();
+        
+        for (std::size_t i = 0; i < std::min<std::size_t>(sorted.size(), maxEntries); ++i)
+        {
+            object->setProperty(sorted[i].first, sorted[i].second);
+        }
+        
+        numUnsaved = 0;
+    }
+    
+    (void) file.replaceWithText(juce::JSON::toString(juce::var(object.get())));
+}
+
+//======================================================================================================================
+bool QueryLog::record(const juce::String &qualifiedName)
+{
+    const juce::ScopedLock scoped_lock(lock);
+    ++counts[qualifiedName];
+    
+    // Counting goes on while a save is pending, only the first one to get there asks for it
+    return (++numUnsaved == saveInterval);
+}
+
+//======================================================================================================================
+juce::StringArray QueryLog::getMostFrequent(int count)
+{
+    const juce::ScopedLock scoped_lock(lock);
+    const std::vector<std::pair<juce::String, int>> sorted = getSortedCounts();
+    
+    juce::StringArray output;
+    
+    for (int i = 0; i < std::min(count, static_cast<int>(sorted.size())); ++i)
+    {
+        output.add(sorted[static_cast<std::size_t>(i)].first);
+    }
+    
+    return output;
+}
+
+//======================================================================================================================
+std::vector<std::pair<juce::String, int>> QueryLog::getSortedCounts() const
+{
+    std::vector<std::pair<juce::String, int>> sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), [](auto &&a, auto &&b)
+    {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+    
+    return sorted;
+}
+//======================================================================================================================
+// endregion QueryLog
+//**********************************************************************************************************************
@@ -0,0 +1,48 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <unordered_map>
+
+//======================================================================================================================
+/**
+ *  Counts how often each symbol was asked for and keeps these counts in a file, so that they survive a restart.
+ *  The file is rewritten every few recorded queries, not on every single one, and never by record() itself.
+ */
+class QueryLog
+{
+public:
+    explicit QueryLog(juce::File file);
+    
+    //==================================================================================================================
+    void load();
+    
+    /** Writes the counts if any query came in since they were last written. */
+    void save();
+    
+    //==================================================================================================================
+    /**
+     *  Counts a query for the given symbol.
+     *  Returns true when enough of them came in since the last save, save() should then be called from somewhere that
+     *  doesn't hold up anyone waiting for a reply. Until that save happened, this won't return true again.
+     */
+    bool record(const juce::String &qualifiedName);
+    
+    //==================================================================================================================
+    juce::StringArray getMostFrequent(int count);
+    
+private:
+    static constexpr int saveInterval = 20;
+    static constexpr int maxEntries   = 1000;
+    
+    //==================================================================================================================
+    juce::File                            file;
+    std::unordered_map<juce::String, int> counts;
+    int                                   numUnsaved { 0 };
+    juce::CriticalSection                 lock;
+    juce::CriticalSection                 fileLock;
+    
+    //==================================================================================================================
+    std::vector<std::pair<juce::String, int>> getSortedCounts() const;
+};
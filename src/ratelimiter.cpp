@@ -0,0 +1,199 @@
+
+#include "ratelimiter.h"
+
+// STL
+#include <algorithm>
+
+//**********************************************************************************************************************
+// region TokenBucket
+//======================================================================================================================
+TokenBucket::TokenBucket(double tokensPerSecond, int burstSize, std::uint64_t nowMs) noexcept
+    : unitsPerMs(tokensPerSecond),
+      capacity(std::min<std::uint64_t>(static_cast<std::uint64_t>(std::max(1, burstSize)) * tokenUnit, tokenMask))
+{
+    state.store((nowMs << tokenBits) | capacity, std::memory_order_relaxed);
+}
+
+//======================================================================================================================
+bool TokenBucket::tryAcquire(std::uint64_t nowMs) noexcept
+{
+    std::uint64_t current = state.load(std::memory_order_relaxed);
+    
+    for (;;)
+    {
+        const std::uint64_t refilled = refill(current, nowMs);
+        
+        if ((refilled & tokenMask) < tokenUnit)
+        {
+            return false;
+        }
+        
+        if (state.compare_exchange_weak(current, refilled - tokenUnit, std::memory_order_acq_rel,
+                                        std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+    
+    if (noticeSent.load(std::memory_order_relaxed))
+    {
+        noticeSent.store(false, std::memory_order_relaxed);
+    }
+    
+    return true;
+}
+
+bool TokenBucket::isFull(std::uint64_t nowMs) const noexcept
+{
+    return (refill(state.load(std::memory_order_relaxed), nowMs) & tokenMask) >= capacity;
+}
+
+void TokenBucket::release(std::uint64_t nowMs) noexcept
+{
+    std::uint64_t current = state.load(std::memory_order_relaxed);
+    
+    for (;;)
+    {
+        const std::uint64_t refilled = refill(current, nowMs);
+        const std::uint64_t tokens   = std::min(capacity, (refilled & tokenMask) + tokenUnit);
+        
+        if (state.compare_exchange_weak(current, (refilled & ~tokenMask) | tokens, std::memory_order_acq_rel,
+                                        std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+}
+
+//======================================================================================================================
+std::uint64_t TokenBucket::refill(std::uint64_t packed, std::uint64_t nowMs) const noexcept
+{
+    const std::uint64_t last   = packed >> tokenBits;
+    const std::uint64_t tokens = packed &  tokenMask;
+    
+    // Another thread may already have stored a later time, in that case there is nothing to add
+    if (nowMs <= last)
+    {
+        return packed;
+    }
+    
+    const auto added = static_cast<std::uint64_t>(static_cast<double>(nowMs - last) * unitsPerMs);
+    
+    // Keep the old time until at least a thousandth of a token has accumulated, or slow rates would never refill
+    if (added == 0)
+    {
+        return packed;
+    }
+    
+    return (nowMs << tokenBits) | std::min(capacity, tokens + added);
+}
+//======================================================================================================================
+// endregion TokenBucket
+//**********************************************************************************************************************
+// region RateLimiter
+//======================================================================================================================
+RateLimiter::RateLimiter(int requestsPerMinute, int parBurstSize)
+    : tokensPerSecond(std::max(0, requestsPerMinute) / 60.0), burstSize(std::max(1, parBurstSize))
+{}
+
+//======================================================================================================================
+RateLimiter::Verdict RateLimiter::acquire(const std::string &key)
+{
+    if (tokensPerSecond <= 0.0)
+    {
+        (void) numAdmitted.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Admitted;
+    }
+    
+    const std::uint64_t now = getNow();
+    
+    {
+        const juce::ScopedReadLock read_lock(lock);
+        
+        if (auto it = buckets.find(key); it != buckets.end())
+        {
+            return acquireFrom(*it->second, now);
+        }
+    }
+    
+    const juce::ScopedWriteLock write_lock(lock);
+    
+    if (buckets.size() >= pruneThreshold)
+    {
+        pruneIdleBuckets(now);
+    }
+    
+    std::unique_ptr<TokenBucket> &bucket = buckets[key];
+    
+    if (!bucket)
+    {
+        bucket = std::make_unique<TokenBucket>(tokensPerSecond, burstSize, now);
+    }
+    
+    return acquireFrom(*bucket, now);
+}
+
+void RateLimiter::refund(const std::string &key)
+{
+    if (tokensPerSecond <= 0.0)
+    {
+        return;
+    }
+    
+    const juce::ScopedReadLock read_lock(lock);
+    
+    if (auto it = buckets.find(key); it != buckets.end())
+    {
+        it->second->release(getNow());
+        (void) numAdmitted.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+RateLimiter::Counters RateLimiter::getCounters() const
+{
+    const juce::ScopedReadLock read_lock(lock);
+    return {
+        numAdmitted.load(std::memory_order_relaxed),
+        numRefused .load(std::memory_order_relaxed),
+        numNotices .load(std::memory_order_relaxed),
+        buckets.size()
+    };
+}
+
+//======================================================================================================================
+std::uint64_t RateLimiter::getNow() noexcept
+{
+    return static_cast<std::uint64_t>(juce::Time::getMillisecondCounterHiRes());
+}
+
+//======================================================================================================================
+RateLimiter::Verdict RateLimiter::acquireFrom(TokenBucket &bucket, std::uint64_t nowMs)
+{
+    if (bucket.tryAcquire(nowMs))
+    {
+        (void) numAdmitted.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Admitted;
+    }
+    
+    (void) numRefused.fetch_add(1, std::memory_order_relaxed);
+    
+    if (bucket.claimNotice())
+    {
+        (void) numNotices.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Refused;
+    }
+    
+    return Verdict::RefusedSilently;
+}
+
+void RateLimiter::pruneIdleBuckets(std::uint64_t nowMs)
+{
+    // A bucket that has refilled completely behaves exactly like a new one, so it can go
+    for (auto it = buckets.begin(); it != buckets.end();)
+    {
+        it = (it->second->isFull(nowMs) ? buckets.erase(it) : std::next(it));
+    }
+}
+//======================================================================================================================
+// endregion RateLimiter
+//**********************************************************************************************************************
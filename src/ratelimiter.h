@@ -0,0 +1,101 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//======================================================================================================================
+/**
+ *  A token bucket whose whole state fits into one word, so taking a token is a single compare and swap.
+ *  The upper bits hold the time of the last refill in milliseconds, the lower bits the tokens in thousandths.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket(double tokensPerSecond, int burstSize, std::uint64_t nowMs) noexcept;
+    
+    //==================================================================================================================
+    /** Takes a token if there is one, a successful call also re-arms the refusal notice. */
+    bool tryAcquire(std::uint64_t nowMs) noexcept;
+    bool isFull(std::uint64_t nowMs)     const noexcept;
+    
+    /** Puts back a token taken for a request that was refused somewhere else after all. */
+    void release(std::uint64_t nowMs) noexcept;
+    
+    //==================================================================================================================
+    /** Returns true for the first refusal since the last admitted request, only then the user gets told. */
+    bool claimNotice() noexcept { return !noticeSent.exchange(true, std::memory_order_relaxed); }
+    
+private:
+    static constexpr int           tokenBits = 24;
+    static constexpr std::uint64_t tokenMask = (std::uint64_t(1) << tokenBits) - 1;
+    static constexpr std::uint64_t tokenUnit = 1000;
+    
+    //==================================================================================================================
+    std::atomic<std::uint64_t> state;
+    std::atomic<bool>          noticeSent { false };
+    
+    const double        unitsPerMs;
+    const std::uint64_t capacity;
+    
+    //==================================================================================================================
+    std::uint64_t refill(std::uint64_t packed, std::uint64_t nowMs) const noexcept;
+};
+
+//======================================================================================================================
+/** Keeps one TokenBucket per key, for instance per guild or per user. */
+class RateLimiter
+{
+public:
+    enum class Verdict
+    {
+        Admitted,
+        Refused,
+        RefusedSilently
+    };
+    
+    struct Counters
+    {
+        std::uint64_t admitted;
+        std::uint64_t refused;
+        std::uint64_t notices;
+        std::size_t   buckets;
+    };
+    
+    //==================================================================================================================
+    /** A rate of 0 disables the limiter. */
+    RateLimiter(int requestsPerMinute, int burstSize);
+    
+    //==================================================================================================================
+    Verdict  acquire(const std::string &key);
+    void     refund(const std::string &key);
+    Counters getCounters() const;
+    
+private:
+    using BucketMap = std::unordered_map<std::string, std::unique_ptr<TokenBucket>>;
+    
+    //==================================================================================================================
+    static constexpr std::size_t pruneThreshold = 4096;
+    
+    //==================================================================================================================
+    BucketMap                   buckets;
+    mutable juce::ReadWriteLock lock;
+    
+    const double tokensPerSecond;
+    const int    burstSize;
+    
+    std::atomic<std::uint64_t> numAdmitted { 0 };
+    std::atomic<std::uint64_t> numRefused  { 0 };
+    std::atomic<std::uint64_t> numNotices  { 0 };
+    
+    //==================================================================================================================
+    static std::uint64_t getNow() noexcept;
+    
+    //==================================================================================================================
+    Verdict acquireFrom(TokenBucket &bucket, std::uint64_t nowMs);
+    void    pruneIdleBuckets(std::uint64_t nowMs);
+};
@@ -0,0 +1,117 @@
+
+#include "renderpool.h"
+
+//**********************************************************************************************************************
+// region RenderPool
+//======================================================================================================================
+RenderPool::RenderPool(int numThreads, int parMaxPending)
+    : maxPending(parMaxPending),
+      pool(juce::jmax(1, numThreads))
+{}
+
+//======================================================================================================================
+bool RenderPool::submit(const std::string &key, Job job, Callback callback)
+{
+    {
+        const std::lock_guard lock(mutex);
+        
+        if (auto it = pending.find(key); it != pending.end())
+        {
+            it->second.emplace_back(std::move(callback));
+            return true;
+        }
+        
+        if (static_cast<int>(pending.size()) >= maxPending)
+        {
+            return false;
+        }
+        
+        (void) pending.emplace(key, std::vector<Callback>{ std::move(callback) });
+    }
+    
+    pool.addJob([this, key, job = std::move(job)]()
+    {
+        Image        image;
+        const double start_time = juce::Time::getMillisecondCounterHiRes();
+        
+        try
+        {
+            image = job();
+        }
+        catch (...)
+        {
+            // A failed render is just a missing image, the waiting requests still have to be answered
+        }
+        
+        addRenderTime(juce::Time::getMillisecondCounterHiRes() - start_time);
+        
+        std::vector<Callback>              callbacks;
+        std::vector<std::function<void()>> now_available;
+        
+        {
+            const std::lock_guard lock(mutex);
+            
+            if (auto it = pending.find(key); it != pending.end())
+            {
+                callbacks = std::move(it->second);
+                pending.erase(it);
+            }
+            
+            std::swap(now_available, waiting);
+        }
+        
+        for (const auto &callback : callbacks)
+        {
+            callback(image);
+        }
+        
+        for (const auto &callback : now_available)
+        {
+            callback();
+        }
+    });
+    
+    return true;
+}
+
+void RenderPool::whenAvailable(std::function<void()> callback)
+{
+    {
+        const std::lock_guard lock(mutex);
+        
+        // Checked under the same lock a finishing render takes, so the call back can't be missed in between
+        if (static_cast<int>(pending.size()) >= maxPending)
+        {
+            waiting.emplace_back(std::move(callback));
+            return;
+        }
+    }
+    
+    callback();
+}
+
+//======================================================================================================================
+int RenderPool::getNumPending() const
+{
+    const std::lock_guard lock(mutex);
+    return static_cast<int>(pending.size());
+}
+
+double RenderPool::getEstimatedWaitMs() const
+{
+    // Everything pending is ahead of a new render, the one running included, and then the new render itself
+    const std::lock_guard lock(mutex);
+    return static_cast<double>(pending.size() + 1) * averageRenderMs / pool.getNumThreads();
+}
+
+//======================================================================================================================
+void RenderPool::addRenderTime(double renderMs)
+{
+    static constexpr double weight = 0.2;
+    
+    const std::lock_guard lock(mutex);
+    averageRenderMs = (averageRenderMs > 0.0 ? averageRenderMs + weight * (renderMs - averageRenderMs) : renderMs);
+}
+//======================================================================================================================
+// endregion RenderPool
+//**********************************************************************************************************************
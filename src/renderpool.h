@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//======================================================================================================================
+/**
+ *  Renders images off the calling thread, with a limit on how many renders can be waiting at once.
+ *  Asking for a render that is already queued or running doesn't queue another one, the caller just gets the same
+ *  image once it's done.
+ *  Callbacks are called on the render thread, anything taking long should be passed on to another pool.
+ */
+class RenderPool
+{
+public:
+    using Image    = std::shared_ptr<const juce::File>;
+    using Job      = std::function<Image()>;
+    using Callback = std::function<void(const Image&)>;
+    
+    //==================================================================================================================
+    RenderPool(int numThreads, int maxPending);
+    
+    //==================================================================================================================
+    /** Returns false if the queue is full, the job is dropped and the callback never called in that case. */
+    bool submit(const std::string &key, Job job, Callback callback);
+    
+    /** Calls back once there is room in the queue again, right away if there already is. */
+    void whenAvailable(std::function<void()> callback);
+    
+    //==================================================================================================================
+    int getNumPending() const;
+    
+    /** Roughly how long a render submitted now would take to finish, going by how long recent renders took. */
+    double getEstimatedWaitMs() const;
+    
+private:
+    std::unordered_map<std::string, std::vector<Callback>> pending;
+    std::vector<std::function<void()>>                     waiting;
+    mutable std::mutex                                     mutex;
+    const int                                              maxPending;
+    double                                                 averageRenderMs { 0.0 };
+    
+    //==================================================================================================================
+    void addRenderTime(double renderMs);
+    
+    // Declared last so that no running job can outlive the callbacks it calls
+    juce::ThreadPool pool;
+};
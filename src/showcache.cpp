@@ -0,0 +1,199 @@
+
+#include "showcache.h"
+
+// STL
+#include <algorithm>
+
+namespace
+{
+    std::uint64_t mixBits(std::uint64_t value) noexcept
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+    
+    std::size_t getEmbedSize(const sld::Embed &embed) noexcept
+    {
+        std::size_t size = embed.title.size() + embed.description.size() + embed.url.size() + embed.timestamp.size()
+                           + embed.footer.text.size() + embed.footer.iconUrl.size() + embed.author.name.size()
+                           + embed.author.iconUrl.size() + embed.image.url.size();
+        
+        for (const auto &field : embed.fields)
+        {
+            size += field.name.size() + field.value.size();
+        }
+        
+        return size;
+    }
+}
+
+//**********************************************************************************************************************
+// region FrequencySketch
+//======================================================================================================================
+FrequencySketch::FrequencySketch(std::size_t expectedEntries)
+{
+    // A few counters per expected entry keep collisions rare, the width has to be a power of two for the mask
+    std::size_t width = 64;
+    
+    while (width < expectedEntries * 8)
+    {
+        width <<= 1;
+    }
+    
+    counters.assign(width * numRows, 0);
+    mask       = width - 1;
+    sampleSize = width * 10;
+}
+
+//======================================================================================================================
+void FrequencySketch::increment(std::uint64_t key) noexcept
+{
+    const std::uint64_t hash = ::mixBits(key);
+    
+    for (int row = 0; row < numRows; ++row)
+    {
+        std::uint8_t &counter = counters[getIndex(hash, row)];
+        counter = static_cast<std::uint8_t>(std::min<int>(counter + 1, maxCount));
+    }
+    
+    if (++numIncrements >= sampleSize)
+    {
+        halve();
+    }
+}
+
+std::uint32_t FrequencySketch::estimate(std::uint64_t key) const noexcept
+{
+    const std::uint64_t hash   = ::mixBits(key);
+    std::uint8_t        result = maxCount;
+    
+    for (int row = 0; row < numRows; ++row)
+    {
+        result = std::min(result, counters[getIndex(hash, row)]);
+    }
+    
+    return result;
+}
+
+//======================================================================================================================
+std::size_t FrequencySketch::getIndex(std::uint64_t hash, int row) const noexcept
+{
+    // Every row needs its own hash function, these are derived from the one hash by seeding it with the row
+    const auto row_hash = static_cast<std::size_t>(::mixBits(hash + 0x9E3779B97F4A7C15ull * (row + 1))) & mask;
+    return static_cast<std::size_t>(row) * (mask + 1) + row_hash;
+}
+
+void FrequencySketch::halve() noexcept
+{
+    for (auto &counter : counters)
+    {
+        counter >>= 1;
+    }
+    
+    numIncrements /= 2;
+}
+//======================================================================================================================
+// endregion FrequencySketch
+//**********************************************************************************************************************
+// region ShowCache
+//======================================================================================================================
+std::uint64_t ShowCache::makeKey(EntityId id, const juce::String &commit) noexcept
+{
+    return static_cast<std::uint64_t>(commit.hashCode64()) ^ id;
+}
+
+//======================================================================================================================
+ShowCache::ShowCache(std::size_t parMaxBytes)
+    : sketch(std::max<std::size_t>(1, parMaxBytes / averageResultSize)),
+      maxBytes(parMaxBytes)
+{}
+
+//======================================================================================================================
+ShowCache::ResultPtr ShowCache::get(std::uint64_t key)
+{
+    const std::lock_guard lock(mutex);
+    
+    // Misses count as well, that's how a new result earns its place
+    sketch.increment(key);
+    
+    if (auto it = lookup.find(key); it != lookup.end())
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->result;
+    }
+    
+    return nullptr;
+}
+
+bool ShowCache::put(std::uint64_t key, ResultPtr result)
+{
+    const std::size_t cost = getCost(*result);
+    
+    if (cost > maxBytes)
+    {
+        return false;
+    }
+    
+    const std::lock_guard lock(mutex);
+    
+    if (auto it = lookup.find(key); it != lookup.end())
+    {
+        numBytes -= it->second->cost;
+        entries.erase(it->second);
+        lookup.erase(it);
+    }
+    
+    // Find out what would have to go first, the newcomer is only let in if it is wanted more than all of these
+    const std::uint32_t frequency   = sketch.estimate(key);
+    std::size_t         freed       = 0;
+    std::size_t         num_victims = 0;
+    
+    for (auto it = entries.rbegin(); it != entries.rend() && numBytes - freed + cost > maxBytes; ++it)
+    {
+        if (sketch.estimate(it->key) >= frequency)
+        {
+            return false;
+        }
+        
+        freed += it->cost;
+        ++num_victims;
+    }
+    
+    for (std::size_t i = 0; i < num_victims; ++i)
+    {
+        numBytes -= entries.back().cost;
+        (void) lookup.erase(entries.back().key);
+        entries.pop_back();
+    }
+    
+    entries.push_front(Entry{ key, std::move(result), cost });
+    lookup[key] = entries.begin();
+    numBytes   += cost;
+    
+    return true;
+}
+
+//======================================================================================================================
+std::size_t ShowCache::size() const
+{
+    const std::lock_guard lock(mutex);
+    return entries.size();
+}
+
+std::size_t ShowCache::getNumBytes() const
+{
+    const std::lock_guard lock(mutex);
+    return numBytes;
+}
+
+//======================================================================================================================
+std::size_t ShowCache::getCost(const ShowResult &result) noexcept
+{
+    return sizeof(Entry) + sizeof(ShowResult) + result.serialised.size() + ::getEmbedSize(result.embed);
+}
+//======================================================================================================================
+// endregion ShowCache
+//**********************************************************************************************************************
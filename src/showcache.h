@@ -0,0 +1,114 @@
+
+#pragma once
+
+#include "symbolindex.h"
+
+#include <juce_core/juce_core.h>
+#include <sleepy_discord/embed.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+//======================================================================================================================
+namespace sld = SleepyDiscord;
+
+//======================================================================================================================
+/** Everything a show request sends for one entity. */
+struct ShowResult
+{
+    sld::Embed embed;
+    
+    // The embed as it goes into the message payload, so that a cached result doesn't need to be serialised again
+    std::string serialised;
+    
+    // Results can be shared by several requests, the image can't be evicted or deleted while any of them holds it
+    std::shared_ptr<const juce::File> graph;
+    
+    // Set for classes whose inheritance graph still has to be rendered and attached
+    bool needsGraph { false };
+};
+
+//======================================================================================================================
+/**
+ *  Approximately counts how often each key was asked for recently, in a fixed amount of memory.
+ *  All counts are halved every now and then, so that what was popular a long time ago doesn't stick around forever.
+ */
+class FrequencySketch
+{
+public:
+    explicit FrequencySketch(std::size_t expectedEntries);
+    
+    //==================================================================================================================
+    void          increment(std::uint64_t key) noexcept;
+    std::uint32_t estimate(std::uint64_t key)  const noexcept;
+    
+private:
+    static constexpr int          numRows  = 4;
+    static constexpr std::uint8_t maxCount = 15;
+    
+    //==================================================================================================================
+    std::vector<std::uint8_t> counters;
+    std::size_t               mask;
+    std::size_t               sampleSize;
+    std::size_t               numIncrements { 0 };
+    
+    //==================================================================================================================
+    std::size_t getIndex(std::uint64_t hash, int row) const noexcept;
+    void        halve() noexcept;
+};
+
+//======================================================================================================================
+/**
+ *  Keeps rendered show results within a byte budget.
+ *  New results only get in if they have been asked for more often than what they would push out, so a flood of
+ *  one-off lookups can't push out the symbols that are shown all the time.
+ *  The budget is for memory only, graph images stay on disk and a cached result just keeps its image from being
+ *  deleted, they count towards GraphCache's budget instead.
+ */
+class ShowCache
+{
+public:
+    using EntityId  = SymbolIndex::EntityId;
+    using ResultPtr = std::shared_ptr<const ShowResult>;
+    
+    //==================================================================================================================
+    /** Different entities of the same commit never share a key, results of other commits are as good as never hit. */
+    static std::uint64_t makeKey(EntityId id, const juce::String &commit) noexcept;
+    
+    //==================================================================================================================
+    explicit ShowCache(std::size_t maxBytes);
+    
+    //==================================================================================================================
+    ResultPtr get(std::uint64_t key);
+    bool      put(std::uint64_t key, ResultPtr result);
+    
+    //==================================================================================================================
+    std::size_t size()        const;
+    std::size_t getNumBytes() const;
+    
+private:
+    struct Entry
+    {
+        std::uint64_t key;
+        ResultPtr     result;
+        std::size_t   cost;
+    };
+    
+    using EntryList = std::list<Entry>;
+    
+    //==================================================================================================================
+    static constexpr std::size_t averageResultSize = 4096;
+    
+    //==================================================================================================================
+    EntryList                                              entries;
+    std::unordered_map<std::uint64_t, EntryList::iterator> lookup;
+    FrequencySketch                                        sketch;
+    std::size_t                                            maxBytes;
+    std::size_t                                            numBytes { 0 };
+    mutable std::mutex                                     mutex;
+    
+    //==================================================================================================================
+    static std::size_t getCost(const ShowResult &result) noexcept;
+};
@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//======================================================================================================================
+/**
+ *  Makes sure that the same work is only done once at a time.
+ *  Whoever asks for a key first computes the result, everyone asking for the same key meanwhile gets that result
+ *  instead of starting their own. The flight stays open after compute returned, until land() is called for the key,
+ *  which is for results that are handed out while they are still being filled in.
+ *  Every waiter gets a copy of the same result, so it should be a cheap handle to something that is safe to share,
+ *  like a shared pointer.
+ */
+template<class Result>
+class SingleFlight
+{
+public:
+    /** Compute has to make sure land() is called eventually, unless it throws. */
+    template<class Fn>
+    Result launch(const std::string &key, Fn &&compute)
+    {
+        std::promise<Result>       promise;
+        std::shared_future<Result> pending;
+        
+        {
+            const std::lock_guard lock(mutex);
+            
+            if (auto it = inFlight.find(key); it != inFlight.end())
+            {
+                pending = it->second;
+            }
+            else
+            {
+                (void) inFlight.emplace(key, promise.get_future().share());
+            }
+        }
+        
+        // Waiting happens outside the lock, other keys must not be held up by this one
+        if (pending.valid())
+        {
+            return pending.get();
+        }
+        
+        try
+        {
+            Result result = std::forward<Fn>(compute)();
+            promise.set_value(result);
+            return result;
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            land(key);
+            throw;
+        }
+    }
+    
+    void land(const std::string &key)
+    {
+        const std::lock_guard lock(mutex);
+        (void) inFlight.erase(key);
+    }
+    
+private:
+    std::unordered_map<std::string, std::shared_future<Result>> inFlight;
+    std::mutex                                                  mutex;
+};
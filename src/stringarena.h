@@ -0,0 +1,52 @@
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+//======================================================================================================================
+/**
+ *  Stores many small strings back to back in one buffer, each of them is referred to by its offset and length.
+ *  The buffer can also be one that is stored somewhere else, like a mapped file, nothing can be added then.
+ */
+class StringArena
+{
+public:
+    struct Span
+    {
+        std::uint32_t offset {};
+        std::uint32_t length {};
+    };
+    
+    //==================================================================================================================
+    Span add(std::string_view text)
+    {
+        const Span span { static_cast<std::uint32_t>(data.size()), static_cast<std::uint32_t>(text.size()) };
+        data.append(text);
+        return span;
+    }
+    
+    std::string_view get(Span span) const noexcept { return getContents().substr(span.offset, span.length); }
+    
+    //==================================================================================================================
+    /** Uses the given strings instead of its own, they have to stay around for as long as this arena is used. */
+    void attach(std::string_view contents)
+    {
+        data.clear();
+        data.shrink_to_fit();
+        attached = contents;
+    }
+    
+    //==================================================================================================================
+    void clear()       noexcept { data.clear(); attached = {}; }
+    void shrinkToFit()          { data.shrink_to_fit(); }
+    
+    //==================================================================================================================
+    std::string_view getContents() const noexcept { return (attached.data() ? attached : std::string_view(data)); }
+    std::size_t      getNumBytes() const noexcept { return getContents().size(); }
+    
+private:
+    std::string      data;
+    std::string_view attached;
+};
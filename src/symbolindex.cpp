@@ -0,0 +1,1057 @@
+
+#include "symbolindex.h"
+
+#include "entitydefinition.h"
+#include "linkresolve.h"
+
+// Doxygen
+#include <arguments.h>
+#include <classdef.h>
+#include <memberdef.h>
+#include <memberlist.h>
+#include <namespacedef.h>
+// STL
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <unordered_set>
+
+namespace
+{
+    // Indexed by EntityType ordinal, decides which kind of entity is offered first for the same prefix
+    constexpr std::array<float, 6> typeWeights {
+        4.0f, // Namespace
+        5.0f, // Class
+        3.0f, // Enum
+        3.5f, // Function
+        1.0f, // Field
+        2.0f  // TypeAlias
+    };
+    
+    constexpr float popularityWeight = 1.5f;
+    
+    // Words that don't change what a type is, as far as searching for it is concerned
+    constexpr std::array<const char*, 11> typeNoise {
+        "const", "volatile", "typename", "struct", "class", "enum", "static", "virtual", "inline", "constexpr",
+        "explicit"
+    };
+    
+    //==================================================================================================================
+    bool prefersType(EntityType type, const juce::String &lastName)
+    {
+        if (lastName.isEmpty())
+        {
+            return false;
+        }
+        
+        // Same heuristic as EntityDefinition::createFromSymbolPath, upper case names are likely types
+        if (juce::CharacterFunctions::isUpperCase(lastName[0]))
+        {
+            return type == EntityType::Class || type == EntityType::Enum || type == EntityType::TypeAlias;
+        }
+        
+        return type == EntityType::Function || type == EntityType::Namespace || type == EntityType::Field;
+    }
+    
+    SymbolIndex::Traits getTraits(EntityType type, const Definition &definition)
+    {
+        SymbolIndex::Traits traits;
+        
+        if (type == EntityType::Class)
+        {
+            const ClassDef &cs_def = static_cast<const ClassDef&>(definition);
+            traits.compoundType    = CompoundType::valueOf(cs_def.compoundTypeString().str(), true);
+        }
+        else if (type == EntityType::Enum)
+        {
+            const MemberDef &en_def = static_cast<const MemberDef&>(definition);
+            traits.compoundType     = (en_def.isEnumStruct() ? CompoundType::EnumClass : CompoundType::Enum);
+        }
+        else if (type == EntityType::Function || type == EntityType::Field)
+        {
+            const MemberDef    &member        = static_cast<const MemberDef&>(definition);
+            const ArgumentList &args          = member.argumentList();
+            const int          qualification = static_cast<int>(args.constSpecifier())
+                                               + (static_cast<int>(args.volatileSpecifier()) * 2);
+            
+            traits.linkage       = Linkage::values[static_cast<int>(member.isExternal())];
+            traits.refQualifier  = VarType::values[args.refQualifier()];
+            traits.qualification = TypeQualifier::values[qualification];
+            traits.ownership     = dynamic_cast<NamespaceDef*>(member.getOuterScope()) ? Ownership::Free
+                                                                     : member.isFriend() ? Ownership::Friend
+                                                                     : member.isStatic() ? Ownership::Static
+                                                                                         : Ownership::Member;
+            traits.virtualness   = Virtualness::values[member.virtualness()];
+            traits.isConstexpr   = member.isConstExpr();
+        }
+        
+        return traits;
+    }
+    
+    template<class Predicate>
+    void narrowCandidates(std::vector<const SymbolIndex::Entity*> &candidates, Predicate &&predicate)
+    {
+        std::vector<const SymbolIndex::Entity*> narrowed;
+        std::copy_if(candidates.begin(), candidates.end(), std::back_inserter(narrowed), predicate);
+        
+        if (!narrowed.empty())
+        {
+            std::swap(candidates, narrowed);
+        }
+    }
+    
+    template<class T>
+    int toOrdinal(const T &value)
+    {
+        // Zero stands for an unset value
+        return (!value ? 0 : value->ordinal() + 1);
+    }
+    
+    //==================================================================================================================
+    // Snapshots are only ever written by the indexer, the checks when reading are there to catch files that were cut
+    // short or come from another version, not to fend off crafted ones
+    constexpr int endMarker = 0x4A444958;
+    
+    int readCount(juce::InputStream &input)
+    {
+        // Every item takes at least a byte, more of them than bytes left can only come from a broken file
+        const int count = input.readInt();
+        return (count >= 0 && count <= input.getNumBytesRemaining() ? count : -1);
+    }
+    
+    template<class T>
+    void writeOrdinal(juce::OutputStream &output, const T &value)
+    {
+        (void) output.writeByte(static_cast<char>(::toOrdinal(value)));
+    }
+    
+    template<class T>
+    T readOrdinal(juce::InputStream &input)
+    {
+        const int ordinal = static_cast<std::uint8_t>(input.readByte()) - 1;
+        return (ordinal >= 0 && ordinal < static_cast<int>(T::values.size()) ? T::values[ordinal] : T{});
+    }
+    
+    void writeSpan(juce::OutputStream &output, StringArena::Span span)
+    {
+        (void) output.writeInt(static_cast<int>(span.offset));
+        (void) output.writeInt(static_cast<int>(span.length));
+    }
+    
+    StringArena::Span readSpan(juce::InputStream &input, const StringArena &arena, bool &isValid)
+    {
+        StringArena::Span span;
+        span.offset = static_cast<std::uint32_t>(input.readInt());
+        span.length = static_cast<std::uint32_t>(input.readInt());
+        isValid    &= (static_cast<std::uint64_t>(span.offset) + span.length <= arena.getNumBytes());
+        return span;
+    }
+    
+    void writeArena(juce::OutputStream &output, const StringArena &arena)
+    {
+        const std::string_view contents = arena.getContents();
+        (void) output.writeInt64(static_cast<juce::int64>(contents.size()));
+        (void) output.write(contents.data(), contents.size());
+    }
+    
+    bool readArena(juce::MemoryInputStream &input, StringArena &arena)
+    {
+        const juce::int64 size = input.readInt64();
+        
+        if (size < 0 || size > input.getNumBytesRemaining())
+        {
+            return false;
+        }
+        
+        const char *const start = static_cast<const char*>(input.getData()) + input.getPosition();
+        arena.attach(std::string_view(start, static_cast<std::size_t>(size)));
+        return input.setPosition(input.getPosition() + size);
+    }
+    
+    void writeIdMap(juce::OutputStream &output, const std::unordered_map<juce::String, SymbolIndex::IdList> &map)
+    {
+        (void) output.writeInt(static_cast<int>(map.size()));
+        
+        for (const auto &[key, ids] : map)
+        {
+            (void) output.writeString(key);
+            (void) output.writeInt(static_cast<int>(ids.size()));
+            
+            for (const auto &id : ids)
+            {
+                (void) output.writeInt(static_cast<int>(id));
+            }
+        }
+    }
+    
+    bool readIdMap(juce::InputStream &input, std::unordered_map<juce::String, SymbolIndex::IdList> &map,
+                   std::size_t numEntities)
+    {
+        const int num_keys = ::readCount(input);
+        
+        for (int i = 0; i < num_keys; ++i)
+        {
+            SymbolIndex::IdList &ids    = map[input.readString()];
+            const int           num_ids = ::readCount(input);
+            
+            if (num_ids < 0)
+            {
+                return false;
+            }
+            
+            for (int j = 0; j < num_ids; ++j)
+            {
+                const auto id = static_cast<SymbolIndex::EntityId>(input.readInt());
+                
+                if (id >= numEntities)
+                {
+                    return false;
+                }
+                
+                ids.emplace_back(id);
+            }
+        }
+        
+        return num_keys >= 0;
+    }
+}
+
+//**********************************************************************************************************************
+// region SymbolIndex
+//======================================================================================================================
+juce::String SymbolIndex::normaliseKey(const juce::String &symbolPath)
+{
+    juce::String key = symbolPath.trim();
+    
+    if (key.endsWith("()"))
+    {
+        key = key.dropLastCharacters(2);
+    }
+    
+    if (key.startsWith("::"))
+    {
+        key = key.substring(2);
+    }
+    
+    return key.toLowerCase();
+}
+
+juce::String SymbolIndex::normaliseType(const juce::String &typeString)
+{
+    // Words are taken apart from the punctuation between them, so that qualifiers inside template arguments go too
+    juce::String output;
+    juce::String word;
+    
+    const auto add_word = [&output, &word]()
+    {
+        if (std::none_of(typeNoise.begin(), typeNoise.end(), [&word](const char *noise) { return word == noise; }))
+        {
+            output << word;
+        }
+        
+        word.clear();
+    };
+    
+    for (auto it = typeString.getCharPointer(); !it.isEmpty(); ++it)
+    {
+        const juce::juce_wchar c = *it;
+        
+        if (juce::CharacterFunctions::isLetterOrDigit(c) || c == '_' || c == ':')
+        {
+            word += c;
+            continue;
+        }
+        
+        add_word();
+        
+        // References, pointers and whitespace don't change what a type is either
+        if (juce::String("<>,()[]").containsChar(c))
+        {
+            output += c;
+        }
+    }
+    
+    add_word();
+    
+    // juce:: is left out by most people asking, so it is dropped everywhere including template arguments
+    return output.replace("juce::", "").toLowerCase();
+}
+
+//======================================================================================================================
+void SymbolIndex::build(const CacheMap &cache)
+{
+    clear();
+    
+    std::unordered_set<const Definition*> known;
+    
+    for (const auto &entry : cache)
+    {
+        IdRange &range = typeRanges[entry.first->ordinal()];
+        range.first    = static_cast<EntityId>(entities.size());
+        
+        for (const auto &def : entry.second)
+        {
+            addEntity(entry.first, def.get());
+            (void) known.emplace(&def.get());
+        }
+        
+        range.last = static_cast<EntityId>(entities.size());
+    }
+    
+    // Constructors are not part of the function cache, but they should still be resolvable by name.
+    // They are kept outside the type ranges so that listings stay the same as before.
+    for (const auto &def : cache[EntityType::Class])
+    {
+        const ClassDef &cs_def = static_cast<const ClassDef&>(def.get());
+        
+        if (const MemberList *const list = cs_def.getMemberList(MemberListType_constructors))
+        {
+            for (const auto &constructor : *list)
+            {
+                if (known.emplace(constructor).second)
+                {
+                    addEntity(EntityType::Function, *constructor);
+                }
+            }
+        }
+    }
+    
+    docPathArena.shrinkToFit();
+    detailArena.shrinkToFit();
+    
+    buildHierarchy();
+    
+    popularity = std::make_unique<std::atomic<std::uint32_t>[]>(entities.size());
+    buildSuggestTrie();
+}
+
+void SymbolIndex::writeTo(juce::OutputStream &output) const
+{
+    ::writeArena(output, docPathArena);
+    ::writeArena(output, listItemArena);
+    ::writeArena(output, detailArena);
+    ::writeArena(output, baseNameArena);
+    
+    (void) output.writeInt(static_cast<int>(entities.size()));
+    
+    for (const auto &entity : entities)
+    {
+        const Traits      &traits = entity.traits;
+        const DetailSpans &spans  = details[entity.id];
+        const auto        item    = (entity.id < listItems.size() ? listItems[entity.id]
+                                                                  : std::pair<StringArena::Span, StringArena::Span>{});
+        
+        ::writeOrdinal(output, entity.type);
+        (void) output.writeString(entity.qualifiedName);
+        ::writeOrdinal(output, traits.compoundType);
+        ::writeOrdinal(output, traits.linkage);
+        ::writeOrdinal(output, traits.refQualifier);
+        ::writeOrdinal(output, traits.qualification);
+        ::writeOrdinal(output, traits.ownership);
+        ::writeOrdinal(output, traits.virtualness);
+        (void) output.writeBool(traits.isConstexpr);
+        
+        ::writeSpan(output, docPaths[entity.id]);
+        ::writeSpan(output, item.first);
+        ::writeSpan(output, item.second);
+        
+        for (const auto &span : { spans.name, spans.documentation, spans.definition, spans.module, spans.parent,
+                                  spans.parameters, spans.enumerators, spans.seeAlso, spans.examples })
+        {
+            ::writeSpan(output, span);
+        }
+        
+        const RelativeList &relatives = getBases(entity.id);
+        (void) output.writeInt(static_cast<int>(relatives.size()));
+        
+        for (const auto &base : relatives)
+        {
+            (void) output.writeInt(static_cast<int>(base.id));
+            (void) output.writeByte(static_cast<char>(base.protection));
+            (void) output.writeBool(base.isVirtual);
+            ::writeSpan(output, base.externalName);
+        }
+    }
+    
+    for (const auto &range : typeRanges)
+    {
+        (void) output.writeInt(static_cast<int>(range.first));
+        (void) output.writeInt(static_cast<int>(range.last));
+    }
+    
+    ::writeIdMap(output, paramTypeMap);
+    ::writeIdMap(output, returnTypeMap);
+    (void) output.writeInt(::endMarker);
+}
+
+bool SymbolIndex::readFrom(juce::MemoryInputStream &input, std::shared_ptr<const void> parMemoryOwner)
+{
+    clear();
+    memoryOwner = std::move(parMemoryOwner);
+    
+    const auto read_entities = [this, &input]()
+    {
+        const int num_entities = ::readCount(input);
+        
+        if (num_entities < 0)
+        {
+            return false;
+        }
+        
+        entities.reserve(static_cast<std::size_t>(num_entities));
+        
+        for (int i = 0; i < num_entities; ++i)
+        {
+            const auto       id   = static_cast<EntityId>(i);
+            const EntityType type = ::readOrdinal<EntityType>(input);
+            
+            if (!type)
+            {
+                return false;
+            }
+            
+            Entity &entity              = entities.emplace_back(Entity{ id, type, input.readString(), {} });
+            entity.traits.compoundType  = ::readOrdinal<CompoundType>(input);
+            entity.traits.linkage       = ::readOrdinal<Linkage>(input);
+            entity.traits.refQualifier  = ::readOrdinal<VarType>(input);
+            entity.traits.qualification = ::readOrdinal<TypeQualifier>(input);
+            entity.traits.ownership     = ::readOrdinal<Ownership>(input);
+            entity.traits.virtualness   = ::readOrdinal<Virtualness>(input);
+            entity.traits.isConstexpr   = input.readBool();
+            
+            bool        is_valid = true;
+            DetailSpans spans;
+            
+            docPaths.emplace_back(::readSpan(input, docPathArena, is_valid));
+            
+            // One after the other, arguments could be read in any order
+            const StringArena::Span name  = ::readSpan(input, listItemArena, is_valid);
+            const StringArena::Span value = ::readSpan(input, listItemArena, is_valid);
+            listItems.emplace_back(name, value);
+            
+            for (auto *span : { &spans.name, &spans.documentation, &spans.definition, &spans.module, &spans.parent,
+                                &spans.parameters, &spans.enumerators, &spans.seeAlso, &spans.examples })
+            {
+                *span = ::readSpan(input, detailArena, is_valid);
+            }
+            
+            details.push_back(spans);
+            
+            RelativeList &relatives = bases.emplace_back();
+            const int    num_bases  = ::readCount(input);
+            
+            for (int j = 0; j < num_bases; ++j)
+            {
+                const auto              base          = static_cast<EntityId>(input.readInt());
+                const int               protection    = input.readByte();
+                const bool              is_virtual    = input.readBool();
+                const StringArena::Span external_name = ::readSpan(input, baseNameArena, is_valid);
+                
+                is_valid &= ((base < static_cast<EntityId>(num_entities) || base == noEntity)
+                             && protection >= 0 && protection <= static_cast<int>(Protection::Package));
+                relatives.push_back(Relative{ base, static_cast<Protection>(protection), is_virtual, external_name });
+            }
+            
+            if (!is_valid || num_bases < 0)
+            {
+                return false;
+            }
+        }
+        
+        for (auto &range : typeRanges)
+        {
+            range.first = static_cast<EntityId>(input.readInt());
+            range.last  = static_cast<EntityId>(input.readInt());
+            
+            if (range.first > range.last || range.last > entities.size())
+            {
+                return false;
+            }
+        }
+        
+        return true;
+    };
+    
+    if (!::readArena(input, docPathArena) || !::readArena(input, listItemArena) || !::readArena(input, detailArena)
+        || !::readArena(input, baseNameArena) || !read_entities() || !::readIdMap(input, paramTypeMap, entities.size())
+        || !::readIdMap(input, returnTypeMap, entities.size()) || input.readInt() != ::endMarker)
+    {
+        clear();
+        return false;
+    }
+    
+    for (EntityId id = 0; id < entities.size(); ++id)
+    {
+        addKeys(id);
+    }
+    
+    buildDerived();
+    
+    popularity = std::make_unique<std::atomic<std::uint32_t>[]>(entities.size());
+    buildSuggestTrie();
+    return true;
+}
+
+//======================================================================================================================
+SymbolIndex::Lookup SymbolIndex::resolve(const juce::String &symbolPath) const
+{
+    Lookup lookup;
+    
+    const IdList *const ids = findBySuffix(symbolPath);
+    
+    if (!ids)
+    {
+        return lookup;
+    }
+    
+    // Overloads share the same qualified name, these resolve to the first declaration like they always did
+    std::vector<const Entity*> &candidates = lookup.candidates;
+    
+    for (const auto &id : *ids)
+    {
+        const Entity &entity = entities[id];
+        
+        if (std::none_of(candidates.begin(), candidates.end(), [&entity](const Entity *candidate)
+        {
+            return candidate->qualifiedName == entity.qualifiedName;
+        }))
+        {
+            candidates.emplace_back(&entity);
+        }
+    }
+    
+    if (candidates.size() > 1)
+    {
+        juce::String path = symbolPath.trim();
+        
+        if (path.endsWith("()"))
+        {
+            path = path.dropLastCharacters(2);
+        }
+        
+        ::narrowCandidates(candidates, [&path](const Entity *entity)
+        {
+            return entity->qualifiedName.endsWith(path);
+        });
+        
+        const juce::String last_name = path.fromLastOccurrenceOf("::", false, true);
+        
+        ::narrowCandidates(candidates, [&last_name](const Entity *entity)
+        {
+            return ::prefersType(entity->type, last_name);
+        });
+    }
+    
+    if (candidates.size() == 1)
+    {
+        lookup.match = candidates.front();
+        candidates.clear();
+    }
+    
+    return lookup;
+}
+
+const SymbolIndex::IdList* SymbolIndex::findBySuffix(const juce::String &symbolPath) const
+{
+    auto it = suffixMap.find(normaliseKey(symbolPath));
+    return (it != suffixMap.end() ? &it->second : nullptr);
+}
+
+//======================================================================================================================
+std::vector<const SymbolIndex::Entity*> SymbolIndex::suggest(const juce::String &prefix, std::size_t maxResults) const
+{
+    const std::vector<EntityId> top = suggestTrie.getTopValues(normaliseKey(prefix).toStdString());
+    
+    std::vector<std::pair<float, const Entity*>> ranked;
+    ranked.reserve(top.size());
+    
+    // Overloads were already narrowed down to one per name when building the trie
+    for (const auto &id : top)
+    {
+        const auto hits = popularity[id].load(std::memory_order_relaxed);
+        ranked.emplace_back(getStaticRank(id) + popularityWeight * std::log2(1.0f + hits), &entities[id]);
+    }
+    
+    std::stable_sort(ranked.begin(), ranked.end(), [](auto &&a, auto &&b) { return a.first > b.first; });
+    
+    std::vector<const Entity*> output;
+    output.reserve(std::min(maxResults, ranked.size()));
+    
+    for (std::size_t i = 0; i < std::min(maxResults, ranked.size()); ++i)
+    {
+        output.emplace_back(ranked[i].second);
+    }
+    
+    return output;
+}
+
+void SymbolIndex::recordQuery(EntityId id) const noexcept
+{
+    if (id < entities.size())
+    {
+        (void) popularity[id].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+//======================================================================================================================
+SymbolIndex::IdList SymbolIndex::findBySignature(const juce::String &paramType, const juce::String &returnType) const
+{
+    const auto find_list = [](const std::unordered_map<juce::String, IdList> &map, const juce::String &type)
+    {
+        auto it = map.find(normaliseType(type));
+        return (it != map.end() ? &it->second : nullptr);
+    };
+    
+    const IdList *const by_param  = (paramType .isEmpty() ? nullptr : find_list(paramTypeMap,  paramType));
+    const IdList *const by_return = (returnType.isEmpty() ? nullptr : find_list(returnTypeMap, returnType));
+    
+    if ((!paramType.isEmpty() && !by_param) || (!returnType.isEmpty() && !by_return))
+    {
+        return {};
+    }
+    
+    if (by_param && by_return)
+    {
+        // Lists are filled in id order, so they are sorted already
+        IdList output;
+        std::set_intersection(by_param->begin(), by_param->end(), by_return->begin(), by_return->end(),
+                              std::back_inserter(output));
+        return output;
+    }
+    
+    return (by_param ? *by_param : by_return ? *by_return : IdList{});
+}
+
+//======================================================================================================================
+std::uint64_t SymbolIndex::getFingerprint() const
+{
+    juce::StringArray keys;
+    keys.ensureStorageAllocated(static_cast<int>(entities.size()));
+    
+    for (const auto &entity : entities)
+    {
+        const std::string_view path = getDocPath(entity.id);
+        keys.add(entity.type->name().data() + (" " + entity.qualifiedName) + " "
+                 + juce::String::fromUTF8(path.data(), static_cast<int>(path.size())));
+    }
+    
+    keys.sort(false);
+    return static_cast<std::uint64_t>(keys.joinIntoString("\n").hashCode64());
+}
+
+std::uint64_t SymbolIndex::getDetailFingerprint() const
+{
+    juce::StringArray keys;
+    keys.ensureStorageAllocated(static_cast<int>(entities.size()));
+    
+    for (const auto &entity : entities)
+    {
+        const Details     details = getDetails(entity.id);
+        juce::StringArray fields;
+        
+        for (const auto &field : { getDocPath(entity.id), details.name, details.documentation, details.definition,
+                                   details.module, details.parent, details.parameters, details.enumerators,
+                                   details.seeAlso })
+        {
+            fields.add(juce::String::fromUTF8(field.data(), static_cast<int>(field.size())));
+        }
+        
+        for (const auto &example : details.examples)
+        {
+            fields.add(juce::String::fromUTF8(example.data(), static_cast<int>(example.size())));
+        }
+        
+        // What the filters look at and how classes relate decide what list and graphs show, they count as well
+        const Traits &traits       = entity.traits;
+        juce::String traits_field;
+        
+        for (const int ordinal : { ::toOrdinal(traits.compoundType), ::toOrdinal(traits.linkage),
+                                   ::toOrdinal(traits.refQualifier), ::toOrdinal(traits.qualification),
+                                   ::toOrdinal(traits.ownership),    ::toOrdinal(traits.virtualness) })
+        {
+            traits_field << ordinal << " ";
+        }
+        
+        fields.add(traits_field + (traits.isConstexpr ? "constexpr" : ""));
+        
+        for (const auto &base : getBases(entity.id))
+        {
+            fields.add(getName(base) + " " + juce::String(static_cast<int>(base.protection))
+                       + (base.isVirtual ? " virtual" : ""));
+        }
+        
+        keys.add(entity.type->name().data() + (" " + entity.qualifiedName) + " " + fields.joinIntoString("\x1f"));
+    }
+    
+    keys.sort(false);
+    return static_cast<std::uint64_t>(keys.joinIntoString("\n").hashCode64());
+}
+
+//======================================================================================================================
+const SymbolIndex::RelativeList& SymbolIndex::getBases(EntityId id) const noexcept
+{
+    static const RelativeList none;
+    return (id < bases.size() ? bases[id] : none);
+}
+
+const SymbolIndex::RelativeList& SymbolIndex::getDerived(EntityId id) const noexcept
+{
+    static const RelativeList none;
+    return (id < derived.size() ? derived[id] : none);
+}
+
+juce::String SymbolIndex::getName(const Relative &relative) const
+{
+    if (relative.isIndexed())
+    {
+        return entities[relative.id].qualifiedName;
+    }
+    
+    const std::string_view name = baseNameArena.get(relative.externalName);
+    return juce::String::fromUTF8(name.data(), static_cast<int>(name.size()));
+}
+
+//======================================================================================================================
+void SymbolIndex::setListItem(EntityId id, std::string_view name, std::string_view value)
+{
+    if (listItems.size() < entities.size())
+    {
+        listItems.resize(entities.size());
+    }
+    
+    listItems[id] = { listItemArena.add(name), listItemArena.add(value) };
+}
+
+SymbolIndex::ListItem SymbolIndex::getListItem(EntityId id) const noexcept
+{
+    if (id >= listItems.size())
+    {
+        return {};
+    }
+    
+    return { listItemArena.get(listItems[id].first), listItemArena.get(listItems[id].second) };
+}
+
+void SymbolIndex::shrinkListItems()
+{
+    listItems.shrink_to_fit();
+    listItemArena.shrinkToFit();
+}
+
+std::string_view SymbolIndex::getDocPath(EntityId id) const noexcept
+{
+    return (id < docPaths.size() ? docPathArena.get(docPaths[id]) : std::string_view{});
+}
+
+SymbolIndex::Details SymbolIndex::getDetails(EntityId id) const
+{
+    if (id >= details.size())
+    {
+        return {};
+    }
+    
+    const DetailSpans &spans = details[id];
+    Details           output {
+        detailArena.get(spans.name),
+        detailArena.get(spans.documentation),
+        detailArena.get(spans.definition),
+        detailArena.get(spans.module),
+        detailArena.get(spans.parent),
+        detailArena.get(spans.parameters),
+        detailArena.get(spans.enumerators),
+        detailArena.get(spans.seeAlso)
+    };
+    
+    // Examples are stored back to back, each one ends with a null character
+    for (std::string_view examples = detailArena.get(spans.examples); !examples.empty();)
+    {
+        const std::size_t end = std::min(examples.find('\0'), examples.size());
+        output.examples.emplace_back(examples.substr(0, end));
+        examples.remove_prefix(std::min(end + 1, examples.size()));
+    }
+    
+    return output;
+}
+
+//======================================================================================================================
+const Definition* SymbolIndex::getDefinition(EntityId id) const noexcept
+{
+    // Asking after the release is a bug, Doxygen might not even be around anymore at that point
+    jassert(!definitions.empty());
+    return (id < definitions.size() ? definitions[id] : nullptr);
+}
+
+void SymbolIndex::releaseDefinitions()
+{
+    std::vector<const Definition*>().swap(definitions);
+}
+
+//======================================================================================================================
+void SymbolIndex::clear()
+{
+    entities.clear();
+    definitions.clear();
+    listItems.clear();
+    listItemArena.clear();
+    docPaths.clear();
+    docPathArena.clear();
+    details.clear();
+    detailArena.clear();
+    baseNameArena.clear();
+    suffixMap.clear();
+    paramTypeMap.clear();
+    returnTypeMap.clear();
+    bases.clear();
+    derived.clear();
+    typeRanges.assign(EntityType::values.size(), IdRange{});
+    
+    // Only once nothing points into it anymore
+    memoryOwner.reset();
+}
+
+void SymbolIndex::addEntity(EntityType type, const Definition &definition)
+{
+    const EntityId id = static_cast<EntityId>(entities.size());
+    entities.push_back(Entity{ id, type, definition.qualifiedName().data(), ::getTraits(type, definition) });
+    definitions.emplace_back(&definition);
+    
+    // Member anchors are MD5 sums of the signature, nothing that should be redone for every request
+    docPaths.emplace_back(docPathArena.add(getUrlFromEntity(type, definition).toRawUTF8()));
+    
+    addKeys(id);
+    
+    if (type == EntityType::Function)
+    {
+        addSignature(id, definition);
+    }
+    
+    addDetails(id, definition);
+}
+
+void SymbolIndex::addKeys(EntityId id)
+{
+    const juce::String key = entities[id].qualifiedName.toLowerCase();
+    int start = 0;
+    
+    while (start >= 0)
+    {
+        suffixMap[key.substring(start)].emplace_back(id);
+        
+        const int separator = key.indexOf(start, "::");
+        start = (separator >= 0 ? separator + 2 : -1);
+    }
+}
+
+void SymbolIndex::addSignature(EntityId id, const Definition &definition)
+{
+    const auto add_type = [id](std::unordered_map<juce::String, IdList> &map, const juce::String &type)
+    {
+        if (type.isEmpty())
+        {
+            return;
+        }
+        
+        // Every type is found by its full name and, for templates, just by the name of the template
+        for (const auto &key : { type, type.upToFirstOccurrenceOf("<", false, false) })
+        {
+            if (IdList &ids = map[key]; ids.empty() || ids.back() != id)
+            {
+                ids.emplace_back(id);
+            }
+        }
+    };
+    
+    const MemberDef &member = static_cast<const MemberDef&>(definition);
+    
+    for (const auto &argument : member.argumentList())
+    {
+        add_type(paramTypeMap, normaliseType(argument.type.data()));
+    }
+    
+    // Constructors have no return type, but they are what gives you an instance of their class, so returns: finds
+    // them next to the factory functions. Destructors aren't found by either.
+    if (member.isConstructor())
+    {
+        add_type(returnTypeMap, normaliseType(entities[id].qualifiedName.upToLastOccurrenceOf("::", false, false)));
+    }
+    else
+    {
+        add_type(returnTypeMap, normaliseType(member.typeString().data()));
+    }
+}
+
+void SymbolIndex::addDetails(EntityId id, const Definition &definition)
+{
+    const EntityType       type = entities[id].type;
+    const EntityDefinition def  = EntityDefinition::createFromEntity(definition, type);
+    
+    juce::String parameters;
+    juce::String enumerators;
+    juce::String see_also;
+    std::string  examples;
+    
+    if (type == EntityType::Function)
+    {
+        if (const auto *commands = def.getCommands(EntityDefinition::CommandIds::param); commands)
+        {
+            for (const auto &[name, value] : *commands)
+            {
+                parameters << name << ": " << value << "\n";
+            }
+        }
+    }
+    else if (type == EntityType::Enum)
+    {
+        for (const auto &enumerator : static_cast<const MemberDef&>(definition).enumFieldList())
+        {
+            enumerators << enumerator->name().data() << ": "
+                        << (enumerator->hasBriefDescription() ? enumerator->briefDescription()
+                                                              : enumerator->documentation()).data() << "\n";
+        }
+    }
+    
+    if (const auto *references = def.getCommands(EntityDefinition::CommandIds::see); references)
+    {
+        for (const auto &[_, name] : *references)
+        {
+            see_also << name << ", ";
+        }
+    }
+    
+    if (const auto *code_blocks = def.getCommands(EntityDefinition::CommandIds::code); code_blocks)
+    {
+        for (const auto &[_, code] : *code_blocks)
+        {
+            examples.append(code.toRawUTF8()).push_back('\0');
+        }
+    }
+    
+    const auto add = [this](const juce::String &text) { return detailArena.add(text.toRawUTF8()); };
+    details.push_back(DetailSpans{
+        add(def->name().data()),
+        add(def.getDocumentation()),
+        add(def.getDefinition()),
+        add(def.getModule()),
+        add(def.getParent()),
+        add(parameters),
+        add(enumerators),
+        add(see_also.trimCharactersAtEnd(", ")),
+        detailArena.add(examples)
+    });
+}
+
+void SymbolIndex::buildHierarchy()
+{
+    const IdRange classes = getEntities(EntityType::Class);
+    
+    std::unordered_map<const Definition*, EntityId> class_ids;
+    class_ids.reserve(classes.size());
+    
+    for (const auto &id : classes)
+    {
+        (void) class_ids.emplace(definitions[id], id);
+    }
+    
+    // Template instances aren't indexed themselves, they count as the template they were made from
+    const auto find_class = [&class_ids](const ClassDef *classDef)
+    {
+        auto it = class_ids.find(classDef);
+        
+        if (it == class_ids.end() && classDef->templateMaster())
+        {
+            it = class_ids.find(classDef->templateMaster());
+        }
+        
+        return (it != class_ids.end() ? it->second : noEntity);
+    };
+    
+    bases.assign(entities.size(), RelativeList{});
+    baseNameArena.clear();
+    
+    for (const auto &id : classes)
+    {
+        const ClassDef &cs_def = static_cast<const ClassDef&>(*definitions[id]);
+        
+        for (const auto &base : cs_def.baseClasses())
+        {
+            const EntityId base_id    = find_class(base.classDef);
+            const bool     is_virtual = (base.virt == Specifier::Virtual);
+            
+            // Bases that aren't part of the docs, like standard library types, are still drawn but only by name
+            if (base_id == noEntity)
+            {
+                const StringArena::Span name = baseNameArena.add(base.classDef->displayName().data());
+                bases[id].push_back(Relative{ base_id, base.prot, is_virtual, name });
+                continue;
+            }
+            
+            bases[id].push_back(Relative{ base_id, base.prot, is_virtual, {} });
+        }
+    }
+    
+    baseNameArena.shrinkToFit();
+    buildDerived();
+}
+
+void SymbolIndex::buildDerived()
+{
+    derived.assign(entities.size(), RelativeList{});
+    
+    // Classes are visited in id order, so the derived lists come out the same on every run
+    for (EntityId id = 0; id < bases.size(); ++id)
+    {
+        for (const auto &base : bases[id])
+        {
+            if (base.isIndexed())
+            {
+                derived[base.id].push_back(Relative{ id, base.protection, base.isVirtual, {} });
+            }
+        }
+    }
+}
+
+void SymbolIndex::buildSuggestTrie()
+{
+    std::vector<PrefixTrie::Entry> trie_entries;
+    trie_entries.reserve(suffixMap.size());
+    
+    for (const auto &[key, ids] : suffixMap)
+    {
+        // Entities with the same name, like overloads, always share all of their keys, only the best ranked one of
+        // them is offered so that they don't take up each other's slots
+        IdList unique_ids;
+        
+        for (const auto &id : ids)
+        {
+            const auto it = std::find_if(unique_ids.begin(), unique_ids.end(), [this, id](EntityId other)
+            {
+                return entities[other].qualifiedName == entities[id].qualifiedName;
+            });
+            
+            if (it == unique_ids.end())
+            {
+                unique_ids.emplace_back(id);
+            }
+            else if (getStaticRank(id) > getStaticRank(*it))
+            {
+                *it = id;
+            }
+        }
+        
+        trie_entries.push_back(PrefixTrie::Entry{ key.toStdString(), std::move(unique_ids) });
+    }
+    
+    suggestTrie.build(std::move(trie_entries), [this](EntityId id) { return getStaticRank(id); });
+}
+
+float SymbolIndex::getStaticRank(EntityId id) const noexcept
+{
+    // Shorter paths are usually the more canonical entities, so they win among equal types
+    const Entity &entity = entities[id];
+    return typeWeights[static_cast<std::size_t>(entity.type->ordinal())]
+           - static_cast<float>(entity.qualifiedName.length()) / 1000.0f;
+}
+//======================================================================================================================
+// endregion SymbolIndex
+//**********************************************************************************************************************
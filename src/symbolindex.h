@@ -0,0 +1,243 @@
+
+#pragma once
+
+#include "prefixtrie.h"
+#include "specs.h"
+#include "stringarena.h"
+
+#include <juce_core/juce_core.h>
+#include <types.h>
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//======================================================================================================================
+class Definition;
+
+//======================================================================================================================
+class SymbolIndex
+{
+public:
+    using EntityId = std::uint32_t;
+    using IdList   = std::vector<EntityId>;
+    using DefVec   = std::vector<std::reference_wrapper<const Definition>>;
+    using CacheMap = venum::VenumMap<EntityType, DefVec>;
+    
+    /** Stands in for the id of something that isn't indexed. */
+    static constexpr EntityId noEntity = std::numeric_limits<EntityId>::max();
+    
+    //==================================================================================================================
+    /** What the list filters look at besides the name, only the ones that apply to the type of an entity are set. */
+    struct Traits
+    {
+        CompoundType  compoundType;
+        Linkage       linkage;
+        VarType       refQualifier;
+        TypeQualifier qualification;
+        Ownership     ownership;
+        Virtualness   virtualness;
+        bool          isConstexpr { false };
+    };
+    
+    struct Entity
+    {
+        EntityId     id;
+        EntityType   type;
+        juce::String qualifiedName;
+        Traits       traits;
+    };
+    
+    struct IdRange
+    {
+        struct Iterator
+        {
+            EntityId id;
+            
+            //==========================================================================================================
+            EntityId  operator*() const noexcept { return id; }
+            Iterator& operator++()      noexcept { ++id; return *this; }
+            
+            bool operator!=(const Iterator &other) const noexcept { return id != other.id; }
+        };
+        
+        //==============================================================================================================
+        EntityId first {};
+        EntityId last  {};
+        
+        //==============================================================================================================
+        Iterator    begin() const noexcept { return { first }; }
+        Iterator    end()   const noexcept { return { last };  }
+        std::size_t size()  const noexcept { return last - first; }
+    };
+    
+    /**
+     *  A base or derived class of some class, how the two are related is kept for drawing them.
+     *  Bases that aren't part of the docs, like standard library types, have no id and only keep their name.
+     */
+    struct Relative
+    {
+        EntityId          id;
+        Protection        protection;
+        bool              isVirtual;
+        StringArena::Span externalName;
+        
+        //==============================================================================================================
+        bool isIndexed() const noexcept { return id != noEntity; }
+    };
+    
+    using RelativeList = std::vector<Relative>;
+    
+    struct ListItem
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+    
+    /** Everything show puts into its embed, taken from Doxygen when indexing. */
+    struct Details
+    {
+        std::string_view              name;
+        std::string_view              documentation;
+        std::string_view              definition;
+        std::string_view              module;
+        std::string_view              parent;
+        std::string_view              parameters;
+        std::string_view              enumerators;
+        std::string_view              seeAlso;
+        std::vector<std::string_view> examples;
+    };
+    
+    struct Lookup
+    {
+        const Entity               *match { nullptr };
+        std::vector<const Entity*> candidates;
+    };
+    
+    //==================================================================================================================
+    static juce::String normaliseKey(const juce::String &symbolPath);
+    static juce::String normaliseType(const juce::String &typeString);
+    
+    //==================================================================================================================
+    void build(const CacheMap &cache);
+    
+    //==================================================================================================================
+    /** Writes everything that takes Doxygen to work out, for readFrom to pick up in another process. */
+    void writeTo(juce::OutputStream &output) const;
+    
+    /**
+     *  Reads an index written by writeTo, what can be worked out again is rebuilt from that.
+     *  Strings are not copied but used right where they are in the stream's memory, the owner of that memory is kept
+     *  around for as long as the index is.
+     *  Returns false if the stream ended early or doesn't look like an index, the index is left empty then.
+     */
+    bool readFrom(juce::MemoryInputStream &input, std::shared_ptr<const void> memoryOwner);
+    
+    //==================================================================================================================
+    Lookup        resolve(const juce::String &symbolPath) const;
+    const IdList* findBySuffix(const juce::String &symbolPath) const;
+    
+    //==================================================================================================================
+    std::vector<const Entity*> suggest(const juce::String &prefix, std::size_t maxResults) const;
+    void recordQuery(EntityId id) const noexcept;
+    
+    //==================================================================================================================
+    /**
+     *  Gets a hash over the type, path and page of every entity, which doesn't depend on the order they were indexed
+     *  in. Two indices with the same fingerprint hold the same entities.
+     */
+    std::uint64_t getFingerprint() const;
+    
+    /**
+     *  Same as getFingerprint, but also takes everything show prints into account, what the filters look at and the
+     *  bases of classes.
+     */
+    std::uint64_t getDetailFingerprint() const;
+    
+    //==================================================================================================================
+    /** Gets all functions taking and returning the given types, an empty type matches everything. */
+    IdList findBySignature(const juce::String &paramType, const juce::String &returnType) const;
+    
+    //==================================================================================================================
+    /** Gets the direct bases of a class and the classes directly deriving from it, bases can be unindexed ones. */
+    const RelativeList& getBases(EntityId id)   const noexcept;
+    const RelativeList& getDerived(EntityId id) const noexcept;
+    juce::String        getName(const Relative &relative) const;
+    
+    //==================================================================================================================
+    /** Stores the field an entity is shown as in list embeds, so that it doesn't have to be built on every page. */
+    void     setListItem(EntityId id, std::string_view name, std::string_view value);
+    ListItem getListItem(EntityId id) const noexcept;
+    
+    /** Gives back what storing list items took beyond what they needed, once all of them have been set. */
+    void shrinkListItems();
+    
+    /** Gets the page and anchor of an entity relative to the docs of the current branch, worked out when indexing. */
+    std::string_view getDocPath(EntityId id) const noexcept;
+    Details          getDetails(EntityId id) const;
+    
+    //==================================================================================================================
+    /**
+     *  Gets the Doxygen definition an entity was indexed from, for whatever else is built from them at startup.
+     *  Nothing can be looked up here anymore once releaseDefinitions() was called, which has to happen before
+     *  Doxygen is torn down.
+     */
+    const Definition* getDefinition(EntityId id) const noexcept;
+    void              releaseDefinitions();
+    
+    //==================================================================================================================
+    const Entity& getEntity(EntityId id)          const noexcept { return entities[id]; }
+    IdRange       getEntities(EntityType type)    const noexcept { return typeRanges[type->ordinal()]; }
+    std::size_t   size()                 const noexcept { return entities.size(); }
+    std::size_t   getNumKeys()           const noexcept { return suffixMap.size(); }
+    
+private:
+    struct DetailSpans
+    {
+        StringArena::Span name;
+        StringArena::Span documentation;
+        StringArena::Span definition;
+        StringArena::Span module;
+        StringArena::Span parent;
+        StringArena::Span parameters;
+        StringArena::Span enumerators;
+        StringArena::Span seeAlso;
+        StringArena::Span examples;
+    };
+    
+    //==================================================================================================================
+    std::vector<Entity>                      entities;
+    std::vector<const Definition*>           definitions;
+    std::vector<IdRange>                     typeRanges;
+    std::unordered_map<juce::String, IdList> suffixMap;
+    std::unordered_map<juce::String, IdList> paramTypeMap;
+    std::unordered_map<juce::String, IdList> returnTypeMap;
+    PrefixTrie                               suggestTrie;
+    
+    std::vector<RelativeList> bases;
+    std::vector<RelativeList> derived;
+    StringArena               baseNameArena;
+    
+    std::vector<std::pair<StringArena::Span, StringArena::Span>> listItems;
+    StringArena                                                  listItemArena;
+    std::vector<StringArena::Span>                               docPaths;
+    StringArena                                                  docPathArena;
+    std::vector<DetailSpans>                                     details;
+    StringArena                                                  detailArena;
+    
+    std::unique_ptr<std::atomic<std::uint32_t>[]> popularity;
+    std::shared_ptr<const void>                   memoryOwner;
+    
+    //==================================================================================================================
+    void  clear();
+    void  addEntity(EntityType type, const Definition &definition);
+    void  addKeys(EntityId id);
+    void  addSignature(EntityId id, const Definition &definition);
+    void  addDetails(EntityId id, const Definition &definition);
+    void  buildHierarchy();
+    void  buildDerived();
+    void  buildSuggestTrie();
+    float getStaticRank(EntityId id) const noexcept;
+};
@@ -0,0 +1,60 @@
+
+#include "attachmentcache.h"
+
+//======================================================================================================================
+class AttachmentCacheTest : public juce::UnitTest
+{
+public:
+    AttachmentCacheTest() : juce::UnitTest("AttachmentCache", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        constexpr std::int64_t hour   = 60 * 60 * 1000;
+        constexpr std::int64_t expiry = std::int64_t(0x65A1B2C3) * 1000;
+        
+        const juce::String link = "https://cdn.discordapp.com/attachments/1/2/graph.png?ex=65a1b2c3&is=65a06143"
+                                  "&hm=0123456789abcdef&";
+        
+        beginTest("Expiry times are read from the ex parameter");
+        expectEquals(AttachmentCache::getExpiryTime(link, 0), expiry);
+        expectEquals(AttachmentCache::getExpiryTime(link.replace("65a1b2c3", "65A1B2C3"), 0), expiry);
+        
+        beginTest("Links without a usable ex parameter get a day");
+        expectEquals(AttachmentCache::getExpiryTime("https://cdn.discordapp.com/attachments/1/2/graph.png", 1000),
+                     1000 + 24 * hour);
+        expectEquals(AttachmentCache::getExpiryTime(link.replace("65a1b2c3", "soon"), 1000), 1000 + 24 * hour);
+        expectEquals(AttachmentCache::getExpiryTime(link.replace("ex=65a1b2c3", "ex="), 1000), 1000 + 24 * hour);
+        
+        beginTest("Links are handed out until an hour before they expire");
+        {
+            AttachmentCache cache;
+            cache.remember("juce::AudioBuffer", link.toStdString(), expiry - 2 * hour);
+            
+            expectEquals(juce::String(cache.find("juce::AudioBuffer", expiry - 2 * hour)), link);
+            expect(cache.find("juce::String", expiry - 2 * hour).empty());
+            
+            expect(cache.find("juce::AudioBuffer", expiry - hour).empty());
+            expectEquals(static_cast<int>(cache.size()), 0);
+        }
+        
+        beginTest("Links that are about to expire aren't remembered");
+        {
+            AttachmentCache cache;
+            cache.remember("juce::AudioBuffer", link.toStdString(), expiry - hour / 2);
+            expectEquals(static_cast<int>(cache.size()), 0);
+        }
+        
+        beginTest("Forgotten links are uploaded again");
+        {
+            AttachmentCache cache;
+            cache.remember("juce::AudioBuffer", link.toStdString(), 0);
+            expectEquals(static_cast<int>(cache.size()), 1);
+            
+            cache.forget("juce::AudioBuffer");
+            expect(cache.find("juce::AudioBuffer", 0).empty());
+        }
+    }
+};
+
+static AttachmentCacheTest attachmentCacheTest;
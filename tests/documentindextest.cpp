@@ -0,0 +1,173 @@
+
+#include "documentindex.h"
+#include "testdefinitions.h"
+
+//======================================================================================================================
+class DocumentIndexTest : public juce::UnitTest
+{
+public:
+    DocumentIndexTest() : juce::UnitTest("DocumentIndex", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        using Tokens = std::vector<std::string>;
+        
+        beginTest("Words are stemmed onto the same term");
+        expect(DocumentIndex::tokenise("classes class")    == Tokens{ "class", "class" });
+        expect(DocumentIndex::tokenise("address")          == Tokens{ "address" });
+        expect(DocumentIndex::tokenise("buffers buffer")   == Tokens{ "buffer", "buffer" });
+        expect(DocumentIndex::tokenise("uses use")         == Tokens{ "use", "use" });
+        expect(DocumentIndex::tokenise("processing processed process") == Tokens{ "process", "process", "process" });
+        
+        beginTest("Identifiers are split, stop words and single letters dropped");
+        expect(DocumentIndex::tokenise("AudioBuffer") == Tokens{ "audio", "buffer", "audiobuffer" });
+        expect(DocumentIndex::tokenise("Returns a juce::String, see x") == Tokens{ "string" });
+        
+        TestDefinitions definitions;
+        (void) definitions.addClass("juce::AudioBuffer", "A multi-channel buffer containing floating point samples.");
+        (void) definitions.addClass("juce::MemoryBlock", "A block of memory, which can be used as a buffer.",
+                                    "Grows as data is appended, the memory is freed when the block is deleted. Copying "
+                                    "a block copies all of its data, moving it just hands over the pointer.");
+        (void) definitions.addClass("juce::Gain",        "Applies a gain to a buffer.");
+        (void) definitions.addClass("juce::String",      "The string classes used everywhere.");
+        
+        SymbolIndex symbols;
+        symbols.build(definitions.getCacheMap());
+        
+        DocumentIndex documents;
+        documents.build(symbols);
+        
+        beginTest("BM25 prefers names and shorter documentation");
+        {
+            const std::vector<DocumentIndex::Hit> hits = documents.search("buffers", 10);
+            
+            expectEquals(static_cast<int>(hits.size()), 3);
+            
+            if (hits.size() == 3)
+            {
+                expectEquals(getName(symbols, hits[0]), juce::String("juce::AudioBuffer"));
+                expectEquals(getName(symbols, hits[1]), juce::String("juce::Gain"));
+                expectEquals(getName(symbols, hits[2]), juce::String("juce::MemoryBlock"));
+                expect(hits[0].score > hits[1].score && hits[1].score > hits[2].score);
+            }
+            
+            expectEquals(static_cast<int>(documents.search("buffer", 1).size()), 1);
+            expectEquals(static_cast<int>(documents.search("class", 10).size()), 1);
+            expect(documents.search("nothing like this", 10).empty());
+        }
+        
+        // Enough entities for gaps and frequencies that take more than one byte
+        TestDefinitions many;
+        
+        for (int i = 0; i < 300; ++i)
+        {
+            const bool is_needle = (i == 0 || i == 299);
+            (void) many.addClass("juce::Filler" + juce::String(i), is_needle ? "needle" : "hay",
+                                 i == 150 ? juce::String::repeatedString("echo ", 200) : juce::String());
+        }
+        
+        SymbolIndex many_symbols;
+        many_symbols.build(many.getCacheMap());
+        
+        DocumentIndex original;
+        original.build(many_symbols);
+        
+        beginTest("Postings with gaps and frequencies that take more than one byte");
+        {
+            const std::vector<DocumentIndex::Hit> needles = original.search("needle", 10);
+            expectEquals(static_cast<int>(needles.size()), 2);
+            
+            for (const auto &hit : needles)
+            {
+                const juce::String name = getName(many_symbols, hit);
+                expect(name == "juce::Filler0" || name == "juce::Filler299");
+            }
+            
+            const std::vector<DocumentIndex::Hit> echoes = original.search("echo", 10);
+            expectEquals(static_cast<int>(echoes.size()), 1);
+            
+            if (!echoes.empty())
+            {
+                expectEquals(getName(many_symbols, echoes.front()), juce::String("juce::Filler150"));
+            }
+            
+            expectEquals(static_cast<int>(original.search("hay", 500).size()), 297);
+        }
+        
+        beginTest("Postings survive a round trip");
+        
+        juce::MemoryOutputStream output;
+        original.writeTo(output);
+        
+        {
+            DocumentIndex copy;
+            juce::MemoryInputStream input(output.getData(), output.getDataSize(), false);
+            expect(copy.readFrom(input, many_symbols.size()));
+            expectEquals(static_cast<int>(copy.getNumTerms()), static_cast<int>(original.getNumTerms()));
+            
+            for (const char *query : { "needle", "echo", "hay" })
+            {
+                const std::vector<DocumentIndex::Hit> expected = original.search(query, 500);
+                const std::vector<DocumentIndex::Hit> actual   = copy.search(query, 500);
+                
+                expectEquals(static_cast<int>(actual.size()), static_cast<int>(expected.size()));
+                
+                for (std::size_t i = 0; i < std::min(actual.size(), expected.size()); ++i)
+                {
+                    expectEquals(static_cast<int>(actual[i].id), static_cast<int>(expected[i].id));
+                    expectWithinAbsoluteError(actual[i].score, expected[i].score, 0.0001f);
+                }
+            }
+        }
+        
+        beginTest("Snapshots of another index are rejected");
+        {
+            DocumentIndex rejected;
+            juce::MemoryInputStream other_input(output.getData(), output.getDataSize(), false);
+            expect(!rejected.readFrom(other_input, many_symbols.size() + 1));
+            
+            juce::MemoryInputStream truncated(output.getData(), output.getDataSize() / 2, false);
+            expect(!rejected.readFrom(truncated, many_symbols.size()));
+            expectEquals(static_cast<int>(rejected.getNumTerms()), 0);
+        }
+        
+        beginTest("Broken postings don't read past their end");
+        {
+            // One term whose varint never ends, and one whose gap points past the last entity
+            const std::uint8_t postings[] { 0xFF, 0xFF, 0xFF, 0x05, 0x01 };
+            
+            juce::MemoryOutputStream broken_output;
+            (void) broken_output.writeInt(2);
+            writeTerm(broken_output, "endless", 0, 3);
+            writeTerm(broken_output, "faraway", 3, 2);
+            (void) broken_output.writeInt64(static_cast<juce::int64>(sizeof(postings)));
+            (void) broken_output.write(postings, sizeof(postings));
+            (void) broken_output.writeInt(2);
+            (void) broken_output.writeShort(1);
+            (void) broken_output.writeShort(1);
+            (void) broken_output.writeFloat(1.0f);
+            
+            DocumentIndex broken;
+            juce::MemoryInputStream input(broken_output.getData(), broken_output.getDataSize(), false);
+            expect(broken.readFrom(input, 2));
+            expect(broken.search("endless faraway", 10).empty());
+        }
+    }
+    
+private:
+    static juce::String getName(const SymbolIndex &index, const DocumentIndex::Hit &hit)
+    {
+        return index.getEntity(hit.id).qualifiedName;
+    }
+    
+    static void writeTerm(juce::OutputStream &output, const juce::String &term, int offset, int length)
+    {
+        (void) output.writeString(term);
+        (void) output.writeInt(offset);
+        (void) output.writeInt(length);
+        (void) output.writeInt(1);
+    }
+};
+
+static DocumentIndexTest documentIndexTest;
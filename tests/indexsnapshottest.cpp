@@ -0,0 +1,131 @@
+
+#include "indexsnapshot.h"
+#include "testdefinitions.h"
+
+//======================================================================================================================
+class IndexSnapshotTest : public juce::UnitTest
+{
+public:
+    IndexSnapshotTest() : juce::UnitTest("IndexSnapshot", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        TestDefinitions definitions;
+        ClassDef &component = definitions.addClass("juce::Component", "The base class for all JUCE user-interface "
+                                                   "objects.");
+        ClassDef &external  = definitions.addClass("std::enable_shared_from_this");
+        ClassDef &button    = definitions.addClass("juce::Button", "A base class for buttons.");
+        
+        definitions.addBase(component, external, Protection::Protected, Specifier::Virtual);
+        definitions.addBase(button,    component);
+        
+        SymbolIndex symbols;
+        symbols.build(definitions.getCacheMap({ &external }));
+        
+        DocumentIndex documents;
+        documents.build(symbols);
+        
+        const juce::TemporaryFile temp_file(".jdsnap");
+        const juce::File          &file = temp_file.getFile();
+        
+        AppConfig::Commit commit;
+        commit.name = "7.0.5";
+        commit.date = "2023-01-30";
+        
+        expect(IndexSnapshot::write(file, commit, symbols, documents));
+        
+        beginTest("A snapshot reads back as the same index");
+        {
+            SymbolIndex   symbols_read;
+            DocumentIndex documents_read;
+            expect(IndexSnapshot::read(file, commit.name, symbols_read, documents_read));
+            
+            expectEquals(static_cast<int>(symbols_read.size()), static_cast<int>(symbols.size()));
+            expect(symbols_read.getFingerprint()       == symbols.getFingerprint());
+            expect(symbols_read.getDetailFingerprint() == symbols.getDetailFingerprint());
+            
+            const SymbolIndex::Lookup lookup = symbols_read.resolve("Button");
+            expect(lookup.match != nullptr);
+            
+            if (lookup.match)
+            {
+                const SymbolIndex::RelativeList &bases = symbols_read.getBases(lookup.match->id);
+                expectEquals(static_cast<int>(bases.size()), 1);
+                expectEquals(symbols_read.getName(bases.front()), juce::String("juce::Component"));
+            }
+            
+            // The base that isn't indexed only has its name, which has to come from the snapshot too
+            if (const SymbolIndex::Entity *const component = symbols_read.resolve("Component").match)
+            {
+                const SymbolIndex::Relative &base = symbols_read.getBases(component->id).front();
+                expect(!base.isIndexed());
+                expect(base.isVirtual && base.protection == Protection::Protected);
+                expectEquals(symbols_read.getName(base), juce::String("std::enable_shared_from_this"));
+            }
+            
+            expectEquals(static_cast<int>(documents_read.search("buttons", 10).size()), 1);
+            expectEquals(static_cast<int>(documents_read.getNumTerms()), static_cast<int>(documents.getNumTerms()));
+        }
+        
+        beginTest("The commit is stored with its date");
+        {
+            const AppConfig::Commit stored = IndexSnapshot::getCommit(file);
+            expectEquals(stored.name, commit.name);
+            expectEquals(stored.date, commit.date);
+            
+            expect(IndexSnapshot::isUpToDate(file, "7.0.5"));
+            expect(!IndexSnapshot::isUpToDate(file, "7.0.6"));
+        }
+        
+        beginTest("Snapshots of other commits are not read");
+        {
+            SymbolIndex   symbols_read;
+            DocumentIndex documents_read;
+            expect(!IndexSnapshot::read(file, "7.0.6", symbols_read, documents_read));
+            expectEquals(static_cast<int>(symbols_read.size()), 0);
+        }
+        
+        beginTest("Broken snapshots are rejected");
+        {
+            juce::MemoryBlock data;
+            expect(file.loadFileAsData(data));
+            
+            // Cut short anywhere, including right before the end marker
+            for (const std::size_t size : { std::size_t(0), std::size_t(6), data.getSize() / 3, data.getSize() / 2,
+                                            data.getSize() - 4, data.getSize() - 1 })
+            {
+                expectRejected(juce::MemoryBlock(data.getData(), size), commit.name);
+            }
+            
+            // The end marker is the last thing written, a file whose end doesn't match was not written by this
+            juce::MemoryBlock wrong_end = data;
+            wrong_end[wrong_end.getSize() - 1] ^= 0x55;
+            expectRejected(wrong_end, commit.name);
+            
+            // Another format version, the file would be read differently
+            juce::MemoryBlock wrong_version = data;
+            wrong_version[4] ^= 0x55;
+            expectRejected(wrong_version, commit.name);
+            
+            juce::MemoryBlock garbage(data.getSize());
+            garbage.fillWith(0xAB);
+            expectRejected(garbage, commit.name);
+            
+            expect(IndexSnapshot::getCommit(juce::File()).name.isEmpty());
+        }
+    }
+    
+private:
+    void expectRejected(const juce::MemoryBlock &data, const juce::String &commit)
+    {
+        const juce::TemporaryFile temp_file(".jdsnap");
+        expect(temp_file.getFile().replaceWithData(data.getData(), data.getSize()));
+        
+        SymbolIndex   symbols;
+        DocumentIndex documents;
+        expect(!IndexSnapshot::read(temp_file.getFile(), commit, symbols, documents));
+    }
+};
+
+static IndexSnapshotTest indexSnapshotTest;
@@ -0,0 +1,104 @@
+
+#include "inheritancegraph.h"
+#include "testdefinitions.h"
+
+//======================================================================================================================
+class InheritanceGraphTest : public juce::UnitTest
+{
+public:
+    InheritanceGraphTest() : juce::UnitTest("InheritanceGraph", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        TestDefinitions definitions;
+        ClassDef &component = definitions.addClass("juce::Component");
+        ClassDef &listener  = definitions.addClass("juce::MouseListener");
+        ClassDef &external  = definitions.addClass("std::enable_shared_from_this");
+        ClassDef &button    = definitions.addClass("juce::Button");
+        
+        definitions.addBase(component, listener);
+        definitions.addBase(component, external, Protection::Protected, Specifier::Virtual);
+        definitions.addBase(button,    component);
+        
+        for (const auto &name : { "juce::Label", "juce::Slider", "juce::ComboBox", "juce::Viewport" })
+        {
+            definitions.addBase(definitions.addClass(name), component);
+        }
+        
+        definitions.addBase(definitions.addClass("juce::TextButton"),   button);
+        definitions.addBase(definitions.addClass("juce::ToggleButton"), button);
+        
+        // Standard library classes aren't part of the docs
+        SymbolIndex index;
+        index.build(definitions.getCacheMap({ &external }));
+        
+        const SymbolIndex::EntityId component_id = index.resolve("juce::Component").match->id;
+        
+        beginTest("Everything within the limits is drawn");
+        {
+            const juce::String dot = InheritanceGraph(index, component_id, GraphLimits{ 2, 10 }).toDot();
+            
+            expect(dot.startsWith("digraph \"juce::Component\""));
+            expectEquals(countNodes(dot), 10);
+            expect(!dot.contains("more..."));
+            expect(dot.contains("[label=\"juce::Component\",style=filled"));
+            expect(dot.contains("[label=\"juce::TextButton\"]"));
+        }
+        
+        beginTest("Bases that aren't indexed are drawn by name only");
+        {
+            const juce::String dot = InheritanceGraph(index, component_id, GraphLimits{ 2, 10 }).toDot();
+            
+            expect(dot.contains("[label=\"std::enable_shared_from_this\",color=\"grey75\"]"));
+            expect(dot.contains("color=\"darkgreen\",style=\"dashed\""));
+            expect(dot.contains("color=\"midnightblue\",style=\"solid\""));
+        }
+        
+        beginTest("Classes past the depth are left out");
+        {
+            const juce::String dot = InheritanceGraph(index, component_id, GraphLimits{ 1, 10 }).toDot();
+            
+            expectEquals(countNodes(dot), 9);
+            expect(!dot.contains("juce::TextButton"));
+            expect(dot.contains("[label=\"2 more...\""));
+        }
+        
+        beginTest("Classes past the width are collapsed into a summary");
+        {
+            const juce::String dot = InheritanceGraph(index, component_id, GraphLimits{ 2, 1 }).toDot();
+            
+            expect(dot.contains("[label=\"juce::MouseListener\""));
+            expect(!dot.contains("std::enable_shared_from_this"));
+            expect(dot.contains("[label=\"1 more...\""));
+            expect(dot.contains("[label=\"4 more...\""));
+            expect(dot.contains("[label=\"juce::Button\""));
+            expect(dot.contains("[label=\"juce::TextButton\""));
+            expect(!dot.contains("juce::ToggleButton"));
+        }
+        
+        beginTest("A depth of zero draws only the class itself and summaries");
+        {
+            const juce::String dot = InheritanceGraph(index, component_id, GraphLimits{ 0, 10 }).toDot();
+            
+            expectEquals(countNodes(dot), 3);
+            expect(dot.contains("[label=\"2 more...\""));
+            expect(dot.contains("[label=\"5 more...\""));
+        }
+    }
+    
+private:
+    static int countNodes(const juce::String &dot)
+    {
+        int num_nodes = 0;
+        
+        for (int i = dot.indexOf("[label="); i >= 0; i = dot.indexOf(i + 1, "[label="))
+        {
+            ++num_nodes;
+        }
+        
+        return num_nodes;
+    }
+};
+
+static InheritanceGraphTest inheritanceGraphTest;
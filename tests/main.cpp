@@ -0,0 +1,31 @@
+
+#include <juce_core/juce_core.h>
+
+// Doxygen
+#include <config.h>
+#include <doxygen.h>
+
+//======================================================================================================================
+// Runs every test that registered itself, the exit code tells ctest whether any of them failed
+int main()
+{
+    // The indices are built from Doxygen's definitions, which can't be made before Doxygen's globals exist.
+    // There is no Doxyfile to read, the defaults are all the tests need.
+    initDoxygen();
+    Config::init();
+    checkConfiguration();
+    adjustConfiguration();
+    
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+    
+    int num_failures = 0;
+    
+    for (int i = 0; i < runner.getNumResults(); ++i)
+    {
+        num_failures += runner.getResult(i)->failures;
+    }
+    
+    return (num_failures > 0 ? 1 : 0);
+}
@@ -0,0 +1,70 @@
+
+#include "prefixtrie.h"
+
+#include <juce_core/juce_core.h>
+
+//======================================================================================================================
+class PrefixTrieTest : public juce::UnitTest
+{
+public:
+    PrefixTrieTest() : juce::UnitTest("PrefixTrie", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        using Values = std::vector<PrefixTrie::ValueId>;
+        
+        // Lower ids rank higher, which makes the expected order easy to tell
+        const PrefixTrie::Ranker rank_by_id = [](PrefixTrie::ValueId value) { return -static_cast<float>(value); };
+        
+        PrefixTrie trie;
+        
+        beginTest("An empty trie finds nothing");
+        trie.build({}, rank_by_id);
+        expect(trie.getTopValues("").empty());
+        expect(trie.getTopValues("a").empty());
+        
+        beginTest("Prefixes find every key below them, best ranked first");
+        trie.build({
+            { "string",      { 4 } },
+            { "stringarray", { 2 } },
+            { "stream",      { 3 } },
+            { "array",       { 1 } },
+            { "arrayref",    { 5, 0 } }
+        }, rank_by_id);
+        
+        expect(trie.getTopValues("")         == Values{ 0, 1, 2, 3, 4, 5 });
+        expect(trie.getTopValues("str")      == Values{ 2, 3, 4 });
+        expect(trie.getTopValues("string")   == Values{ 2, 4 });
+        expect(trie.getTopValues("stringa")  == Values{ 2 });
+        expect(trie.getTopValues("array")    == Values{ 0, 1, 5 });
+        expect(trie.getTopValues("arrayref") == Values{ 0, 5 });
+        
+        beginTest("Prefixes that end inside a compressed label or go past every key");
+        expect(trie.getTopValues("stri") == Values{ 2, 4 });
+        expect(trie.getTopValues("strings").empty());
+        expect(trie.getTopValues("arrayrefs").empty());
+        expect(trie.getTopValues("b").empty());
+        
+        beginTest("Nodes keep no more than the top values");
+        {
+            std::vector<PrefixTrie::Entry> entries;
+            
+            for (PrefixTrie::ValueId i = 0; i < 100; ++i)
+            {
+                entries.push_back({ "key" + std::to_string(i), { i } });
+            }
+            
+            trie.build(std::move(entries), rank_by_id);
+            
+            const Values top = trie.getTopValues("key");
+            expectEquals(static_cast<int>(top.size()), static_cast<int>(PrefixTrie::maxTopValues));
+            expectEquals(static_cast<int>(top.front()), 0);
+            expectEquals(static_cast<int>(top.back()),  static_cast<int>(PrefixTrie::maxTopValues - 1));
+            
+            expect(trie.getTopValues("key99") == Values{ 99 });
+        }
+    }
+};
+
+static PrefixTrieTest prefixTrieTest;
@@ -0,0 +1,108 @@
+
+#include "ratelimiter.h"
+
+//======================================================================================================================
+class RateLimiterTest : public juce::UnitTest
+{
+public:
+    RateLimiterTest() : juce::UnitTest("RateLimiter", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("Buckets start full and hold no more than their burst");
+        {
+            TokenBucket bucket(1.0, 3, 1000);
+            expect(bucket.isFull(1000));
+            
+            expect(bucket.tryAcquire(1000));
+            expect(bucket.tryAcquire(1000));
+            expect(bucket.tryAcquire(1000));
+            expect(!bucket.tryAcquire(1000));
+            expect(!bucket.isFull(1000));
+        }
+        
+        beginTest("Buckets refill at their rate");
+        {
+            TokenBucket bucket(1.0, 3, 1000);
+            
+            for (int i = 0; i < 3; ++i)
+            {
+                (void) bucket.tryAcquire(1000);
+            }
+            
+            expect(!bucket.tryAcquire(1999));
+            expect(bucket.tryAcquire(2000));
+            expect(!bucket.tryAcquire(2000));
+            
+            expect(!bucket.isFull(4999));
+            expect(bucket.isFull(5000));
+            
+            // However long it has been, a bucket never refills past its burst
+            TokenBucket idle(1.0, 2, 1000);
+            expect(idle.tryAcquire(100000));
+            expect(idle.tryAcquire(100000));
+            expect(!idle.tryAcquire(100000));
+        }
+        
+        beginTest("Released tokens can be taken again, up to the burst");
+        {
+            TokenBucket bucket(1.0, 1, 1000);
+            expect(bucket.tryAcquire(1000));
+            
+            bucket.release(1000);
+            expect(bucket.isFull(1000));
+            
+            bucket.release(1000);
+            expect(bucket.tryAcquire(1000));
+            expect(!bucket.tryAcquire(1000));
+        }
+        
+        beginTest("Only the first refusal after an admitted request is noticed");
+        {
+            TokenBucket bucket(1.0, 1, 1000);
+            (void) bucket.tryAcquire(1000);
+            
+            expect(bucket.claimNotice());
+            expect(!bucket.claimNotice());
+            
+            expect(bucket.tryAcquire(2000));
+            expect(bucket.claimNotice());
+        }
+        
+        beginTest("Every key gets its own bucket");
+        {
+            // One token a second, nothing refills noticeably while this runs
+            RateLimiter limiter(60, 2);
+            
+            expect(limiter.acquire("guild") == RateLimiter::Verdict::Admitted);
+            expect(limiter.acquire("guild") == RateLimiter::Verdict::Admitted);
+            expect(limiter.acquire("guild") == RateLimiter::Verdict::Refused);
+            expect(limiter.acquire("guild") == RateLimiter::Verdict::RefusedSilently);
+            expect(limiter.acquire("user")  == RateLimiter::Verdict::Admitted);
+            
+            limiter.refund("guild");
+            expect(limiter.acquire("guild") == RateLimiter::Verdict::Admitted);
+            
+            const RateLimiter::Counters counters = limiter.getCounters();
+            expectEquals(static_cast<int>(counters.admitted), 3);
+            expectEquals(static_cast<int>(counters.refused),  2);
+            expectEquals(static_cast<int>(counters.notices),  1);
+            expectEquals(static_cast<int>(counters.buckets),  2);
+        }
+        
+        beginTest("A rate of 0 admits everything");
+        {
+            RateLimiter limiter(0, 1);
+            
+            for (int i = 0; i < 100; ++i)
+            {
+                expect(limiter.acquire("guild") == RateLimiter::Verdict::Admitted);
+            }
+            
+            expectEquals(static_cast<int>(limiter.getCounters().buckets), 0);
+        }
+    }
+};
+
+static RateLimiterTest rateLimiterTest;
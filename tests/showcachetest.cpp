@@ -0,0 +1,125 @@
+
+#include "showcache.h"
+
+//======================================================================================================================
+class ShowCacheTest : public juce::UnitTest
+{
+public:
+    ShowCacheTest() : juce::UnitTest("ShowCache", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("The sketch counts up to its maximum");
+        {
+            FrequencySketch sketch(100);
+            
+            for (int i = 0; i < 5; ++i)
+            {
+                sketch.increment(1);
+            }
+            
+            expectEquals(static_cast<int>(sketch.estimate(1)), 5);
+            expectEquals(static_cast<int>(sketch.estimate(2)), 0);
+            
+            for (int i = 0; i < 20; ++i)
+            {
+                sketch.increment(1);
+            }
+            
+            expectEquals(static_cast<int>(sketch.estimate(1)), 15);
+        }
+        
+        beginTest("The sketch halves all counts after a sample");
+        {
+            // The smallest sketch has 64 counters per row and halves every 640 increments
+            FrequencySketch sketch(1);
+            
+            for (int i = 0; i < 15; ++i)
+            {
+                sketch.increment(7);
+            }
+            
+            for (int i = 0; i < 624; ++i)
+            {
+                sketch.increment(42);
+            }
+            
+            expectEquals(static_cast<int>(sketch.estimate(7)), 15);
+            
+            sketch.increment(42);
+            expectEquals(static_cast<int>(sketch.estimate(7)),  7);
+            expectEquals(static_cast<int>(sketch.estimate(42)), 7);
+        }
+        
+        beginTest("Keys are unique per entity and commit");
+        expect(ShowCache::makeKey(1, "7.0.5") != ShowCache::makeKey(2, "7.0.5"));
+        expect(ShowCache::makeKey(1, "7.0.5") != ShowCache::makeKey(1, "7.0.6"));
+        expect(ShowCache::makeKey(1, "7.0.5") == ShowCache::makeKey(1, "7.0.5"));
+        
+        beginTest("Results are only let in when they are wanted more than what they push out");
+        {
+            const std::size_t cost = getCost();
+            ShowCache cache(3 * cost);
+            
+            expect(cache.put(1, makeResult()));
+            expect(cache.put(2, makeResult()));
+            expect(cache.put(3, makeResult()));
+            expectEquals(static_cast<int>(cache.size()), 3);
+            expectEquals(static_cast<int>(cache.getNumBytes()), static_cast<int>(3 * cost));
+            
+            // Never asked for, so it doesn't get to push out anything that is just as popular
+            expect(!cache.put(4, makeResult()));
+            expect(cache.get(1) != nullptr);
+            
+            // Asked for twice now, more than the least recently used entry
+            expect(cache.get(4) == nullptr);
+            expect(cache.get(4) == nullptr);
+            expect(cache.put(4, makeResult()));
+            
+            expectEquals(static_cast<int>(cache.size()), 3);
+            expectEquals(static_cast<int>(cache.getNumBytes()), static_cast<int>(3 * cost));
+            expect(cache.get(2) == nullptr);
+            expect(cache.get(1) != nullptr);
+            expect(cache.get(4) != nullptr);
+        }
+        
+        beginTest("The byte budget holds");
+        {
+            const std::size_t cost = getCost();
+            ShowCache cache(2 * cost);
+            
+            // Putting the same key again replaces it instead of counting it twice
+            expect(cache.put(1, makeResult()));
+            expect(cache.put(1, makeResult()));
+            expectEquals(static_cast<int>(cache.getNumBytes()), static_cast<int>(cost));
+            
+            // Larger than the whole budget
+            expect(!cache.put(2, makeResult(3 * cost)));
+            expectEquals(static_cast<int>(cache.size()), 1);
+            
+            ShowCache empty(0);
+            expect(!empty.put(1, makeResult()));
+            expectEquals(static_cast<int>(empty.getNumBytes()), 0);
+        }
+    }
+    
+private:
+    static ShowCache::ResultPtr makeResult(std::size_t payloadSize = 1000)
+    {
+        auto result = std::make_shared<ShowResult>();
+        result->serialised.assign(payloadSize, 'x');
+        result->embed.title = "juce::AudioBuffer";
+        return result;
+    }
+    
+    /** What a result of makeResult() takes up, the cost itself is private. */
+    static std::size_t getCost()
+    {
+        ShowCache probe(std::size_t(1) << 20);
+        (void) probe.put(1, makeResult());
+        return probe.getNumBytes();
+    }
+};
+
+static ShowCacheTest showCacheTest;
@@ -0,0 +1,91 @@
+
+#include "singleflight.h"
+
+#include <juce_core/juce_core.h>
+
+// STL
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+//======================================================================================================================
+class SingleFlightTest : public juce::UnitTest
+{
+public:
+    SingleFlightTest() : juce::UnitTest("SingleFlight", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        beginTest("A flight is shared until it lands");
+        {
+            SingleFlight<int> flights;
+            int num_computed = 0;
+            
+            expectEquals(flights.launch("list", [&num_computed]() { return ++num_computed; }), 1);
+            expectEquals(flights.launch("list", [&num_computed]() { return ++num_computed; }), 1);
+            expectEquals(flights.launch("find", [&num_computed]() { return ++num_computed; }), 2);
+            
+            flights.land("list");
+            expectEquals(flights.launch("list", [&num_computed]() { return ++num_computed; }), 3);
+        }
+        
+        beginTest("Waiters get the result of the running computation");
+        {
+            SingleFlight<int>   flights;
+            std::atomic<int>    num_computed { 0 };
+            juce::WaitableEvent started;
+            juce::WaitableEvent release;
+            int                 first  = 0;
+            int                 second = 0;
+            
+            std::thread leader([&]()
+            {
+                first = flights.launch("list", [&]()
+                {
+                    started.signal();
+                    (void) release.wait(5000);
+                    return ++num_computed;
+                });
+            });
+            
+            expect(started.wait(5000));
+            
+            std::thread waiter([&]()
+            {
+                second = flights.launch("list", [&num_computed]() { return ++num_computed + 100; });
+            });
+            
+            // The flight stays open until it lands, so the waiter can't miss it however late it comes in
+            juce::Thread::sleep(50);
+            release.signal();
+            
+            leader.join();
+            waiter.join();
+            
+            expectEquals(num_computed.load(), 1);
+            expectEquals(first,  1);
+            expectEquals(second, 1);
+        }
+        
+        beginTest("A failed computation lands its flight");
+        {
+            SingleFlight<int> flights;
+            bool              threw = false;
+            
+            try
+            {
+                (void) flights.launch("show", []() -> int { throw std::runtime_error("failed"); });
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+            
+            expect(threw);
+            expectEquals(flights.launch("show", []() { return 42; }), 42);
+        }
+    }
+};
+
+static SingleFlightTest singleFlightTest;
@@ -0,0 +1,76 @@
+
+#include "testdefinitions.h"
+
+//======================================================================================================================
+class SymbolIndexTest : public juce::UnitTest
+{
+public:
+    SymbolIndexTest() : juce::UnitTest("SymbolIndex", "JuceDoc") {}
+    
+    //==================================================================================================================
+    void runTest() override
+    {
+        TestDefinitions definitions;
+        (void) definitions.addClass("juce::AudioBuffer");
+        (void) definitions.addClass("juce::Gain");
+        (void) definitions.addClass("juce::dsp::Gain");
+        (void) definitions.addClass("juce::dsp::ProcessorChain");
+        
+        SymbolIndex index;
+        index.build(definitions.getCacheMap());
+        
+        beginTest("Keys are normalised");
+        expectEquals(SymbolIndex::normaliseKey("  ::juce::String::length() "), juce::String("juce::string::length"));
+        expectEquals(SymbolIndex::normaliseKey("AudioBuffer"), juce::String("audiobuffer"));
+        
+        beginTest("Unqualified names resolve to the only entity with that name");
+        expectResolvesTo(index, "AudioBuffer",         "juce::AudioBuffer");
+        expectResolvesTo(index, "audiobuffer",         "juce::AudioBuffer");
+        expectResolvesTo(index, "::juce::AudioBuffer", "juce::AudioBuffer");
+        expectResolvesTo(index, "ProcessorChain",      "juce::dsp::ProcessorChain");
+        
+        beginTest("Partially qualified paths resolve by their suffix");
+        expectResolvesTo(index, "dsp::Gain",       "juce::dsp::Gain");
+        expectResolvesTo(index, "juce::dsp::Gain", "juce::dsp::Gain");
+        
+        beginTest("Ambiguous names give candidates instead of a match");
+        {
+            const SymbolIndex::Lookup lookup = index.resolve("Gain");
+            expect(lookup.match == nullptr);
+            expectEquals(static_cast<int>(lookup.candidates.size()), 2);
+        }
+        
+        beginTest("Unknown names give nothing");
+        {
+            const SymbolIndex::Lookup lookup = index.resolve("NoSuchClass");
+            expect(lookup.match == nullptr);
+            expect(lookup.candidates.empty());
+            expect(index.findBySuffix("uffer") == nullptr);
+        }
+        
+        beginTest("Types are normalised");
+        expectEquals(SymbolIndex::normaliseType("const juce::String&"), juce::String("string"));
+        expectEquals(SymbolIndex::normaliseType("juce::AudioBuffer<float> *"), juce::String("audiobuffer<float>"));
+        expectEquals(SymbolIndex::normaliseType("std::vector<const juce::String*>"),
+                     juce::String("std::vector<string>"));
+        expectEquals(SymbolIndex::normaliseType("const std::map<juce::String, juce::var> &"),
+                     juce::String("std::map<string,var>"));
+        expectEquals(SymbolIndex::normaliseType("constexpr int"), juce::String("int"));
+        expectEquals(SymbolIndex::normaliseType("juce::constants"), juce::String("constants"));
+    }
+    
+private:
+    void expectResolvesTo(const SymbolIndex &index, const juce::String &symbolPath, const juce::String &expected)
+    {
+        const SymbolIndex::Lookup lookup = index.resolve(symbolPath);
+        
+        expect(lookup.match != nullptr, symbolPath + " didn't resolve");
+        
+        if (lookup.match)
+        {
+            expectEquals(lookup.match->qualifiedName, expected);
+        }
+    }
+};
+
+static SymbolIndexTest symbolIndexTest;
@@ -0,0 +1,107 @@
+
+#pragma once
+
+#include "symbolindex.h"
+
+// Doxygen
+#include <classdef.h>
+#include <namespacedef.h>
+// STL
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+//======================================================================================================================
+/**
+ *  Makes Doxygen definitions the way parsing the sources would, for building indices over a handful of made up
+ *  classes. Everything made is owned by this and has to outlive whatever is built from it.
+ */
+class TestDefinitions
+{
+public:
+    /** Makes the namespaces of the path that don't exist yet, scopes are taken from the qualified name. */
+    NamespaceDef& addNamespace(const juce::String &qualifiedName)
+    {
+        if (NamespaceDef *const existing = findNamespace(qualifiedName))
+        {
+            return *existing;
+        }
+        
+        // Making the outer namespaces adds to the list, this one is only referred to by its address from here on
+        NamespaceDef *const ns_def = namespaces.emplace_back(createNamespaceDef("test.h", 1, 1,
+                                                                                qualifiedName.toRawUTF8())).get();
+        setScope(*toNamespaceDefMutable(ns_def), qualifiedName);
+        return *ns_def;
+    }
+    
+    ClassDef& addClass(const juce::String &qualifiedName, const juce::String &brief = {},
+                       const juce::String &documentation = {})
+    {
+        ClassDef        *const cs_def = classes.emplace_back(createClassDef("test.h", 1, 1, qualifiedName.toRawUTF8(),
+                                                                            ClassDef::Class)).get();
+        ClassDefMutable &mutable_def  = *toClassDefMutable(cs_def);
+        
+        setScope(mutable_def, qualifiedName);
+        mutable_def.setBriefDescription(brief.toRawUTF8(), "test.h", 1);
+        mutable_def.setDocumentation(documentation.toRawUTF8(), "test.h", 1);
+        return *cs_def;
+    }
+    
+    /** Same as a class declared with the base in its base clause. */
+    void addBase(ClassDef &derived, ClassDef &base, Protection protection = Protection::Public,
+                 Specifier virtualness = Specifier::Normal)
+    {
+        toClassDefMutable(&derived)->insertBaseClass(&base, base.name(), protection, virtualness);
+        toClassDefMutable(&base)->insertSubClass(&derived, protection, virtualness);
+    }
+    
+    //==================================================================================================================
+    /** Everything made so far, in the shape the indexer hands it to the symbol index. */
+    SymbolIndex::CacheMap getCacheMap(const std::vector<const ClassDef*> &leftOut = {}) const
+    {
+        SymbolIndex::CacheMap cache;
+        
+        for (const auto &ns_def : namespaces)
+        {
+            cache[EntityType::Namespace].emplace_back(*ns_def);
+        }
+        
+        for (const auto &cs_def : classes)
+        {
+            if (std::find(leftOut.begin(), leftOut.end(), cs_def.get()) == leftOut.end())
+            {
+                cache[EntityType::Class].emplace_back(*cs_def);
+            }
+        }
+        
+        return cache;
+    }
+    
+private:
+    std::vector<std::unique_ptr<NamespaceDef>> namespaces;
+    std::vector<std::unique_ptr<ClassDef>>     classes;
+    
+    //==================================================================================================================
+    NamespaceDef* findNamespace(const juce::String &qualifiedName)
+    {
+        for (const auto &ns_def : namespaces)
+        {
+            if (qualifiedName == ns_def->qualifiedName().data())
+            {
+                return ns_def.get();
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    void setScope(DefinitionMutable &definition, const juce::String &qualifiedName)
+    {
+        const juce::String scope = qualifiedName.upToLastOccurrenceOf("::", false, false);
+        
+        if (scope.isNotEmpty())
+        {
+            definition.setOuterScope(&addNamespace(scope));
+        }
+    }
+};